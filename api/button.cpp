@@ -28,6 +28,7 @@ DEFINE_API(bool, Button, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   return ImGui::Button(label, ImVec2(API_RO_GET(size_w), API_RO_GET(size_h)));
 }
 
@@ -36,6 +37,7 @@ DEFINE_API(bool, SmallButton, (ImGui_Context*,ctx)
 "Button with StyleVar_FramePadding=(0,0) to easily embed within text.")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   return ImGui::SmallButton(label);
 }
 
@@ -62,6 +64,7 @@ DEFINE_API(bool, Checkbox, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   if(!API_RW(v))
     return false;
   return ImGui::Checkbox(label, API_RW(v));
@@ -72,6 +75,7 @@ DEFINE_API(bool, CheckboxFlags, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   return ImGui::CheckboxFlags(label, API_RW(flags), flags_value);
 }
 
@@ -80,6 +84,7 @@ DEFINE_API(bool, RadioButton, (ImGui_Context*,ctx)
 R"(Use with e.g. if (RadioButton("one", my_value==1)) { my_value = 1; })")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   return ImGui::RadioButton(label, active);
 }
 
@@ -88,6 +93,7 @@ DEFINE_API(bool, RadioButtonEx, (ImGui_Context*,ctx)
 "Shortcut to handle RadioButton's example pattern when value is an integer")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   return ImGui::RadioButton(label, API_RW(v), v_button);
 }
 
@@ -35,6 +35,7 @@ R"(Color is in 0xRRGGBBAA or, if ColorEditFlags_NoAlpha is set, 0xXXRRGGBB
 (XX is ignored and will not be modified).)")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   assertValid(API_RW(col_rgba));
 
   ImGuiColorEditFlags flags { API_RO_GET(flags) };
@@ -56,6 +57,7 @@ DEFINE_API(bool, ColorEdit3, (ImGui_Context*,ctx)
 (int*,API_RO(flags),ImGuiColorEditFlags_None),
 "Color is in 0xXXRRGGBB. XX is ignored and will not be modified.")
 {
+  requestGlyphs(label);
   // Edit4 will take care of starting the frame and validating col_rgb
   ImGuiColorEditFlags flags { API_RO_GET(flags) };
   flags |= ImGuiColorEditFlags_NoAlpha;
@@ -68,6 +70,7 @@ DEFINE_API(bool, ColorPicker4, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   assertValid(API_RW(col_rgba));
 
   ImGuiColorEditFlags flags { API_RO_GET(flags) };
@@ -93,6 +96,7 @@ DEFINE_API(bool, ColorPicker3, (ImGui_Context*,ctx)
 (int*,API_RO(flags),ImGuiColorEditFlags_None),
 R"(Color is in 0xXXRRGGBB. XX is ignored and will not be modified.)")
 {
+  requestGlyphs(label);
   // Picker4 will take care of starting the frame and validating col_rgb
   ImGuiColorEditFlags flags { API_RO_GET(flags) };
   flags |= ImGuiColorEditFlags_NoAlpha;
@@ -107,6 +111,7 @@ R"(Display a color square/button, hover for details, return true when pressed.
 Color is in 0xRRGGBBAA or, if ColorEditFlags_NoAlpha is set, 0xRRGGBB.)")
 {
   FRAME_GUARD;
+  requestGlyphs(desc_id);
 
   ImGuiColorEditFlags flags { API_RO_GET(flags) };
   sanitizeColorEditFlags(flags);
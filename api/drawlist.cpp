@@ -36,6 +36,16 @@ custom primitives.
 The Draw List API uses absolute coordinates (0,0 is the top-left corner of the
 rimary monitor, not of your window!). See GetCursorScreenPos.)");
 
+void DrawListProxy::useFontTexture(ImDrawList *drawList)
+{
+  // shapes use the white pixel of the current font's atlas
+  const ImTextureID texture { ImGui::GetFont()->ContainerAtlas->TexID };
+  if(drawList->_CmdHeader.TextureId == texture)
+    return;
+  drawList->_TextureIdStack.back() = texture;
+  drawList->_OnChangedTextureID();
+}
+
 DEFINE_API(ImGui_DrawList*, GetWindowDrawList, (ImGui_Context*,ctx),
 "The draw list associated to the current window, to append your own drawing primitives")
 {
@@ -242,6 +252,7 @@ DEFINE_API(void, DrawList_AddText, (ImGui_DrawList*,draw_list)
 (double,x)(double,y)(int,col_rgba)(const char*,text),
 "")
 {
+  requestGlyphs(text);
   draw_list->get()->AddText(ImVec2(x, y), Color::fromBigEndian(col_rgba), text);
 }
 
@@ -254,6 +265,7 @@ R"(The last pushed font is used if font is nil.
 The size of the last pushed font is used if font_size is 0.
 cpu_fine_clip_rect_* only takes effect if all four are non-nil.)")
 {
+  requestGlyphs(text);
   col_rgba = Color::fromBigEndian(col_rgba);
 
   ImVec2 pos;
@@ -273,9 +285,19 @@ cpu_fine_clip_rect_* only takes effect if all four are non-nil.)")
     cpu_fine_clip_rect_ptr = nullptr;
 
   Context *ctx;
-  draw_list->get(&ctx)->AddText(ctx->fonts().instanceOf(font), font_size,
+  ImDrawList *drawList { draw_list->get(&ctx) };
+  ImFont *instance { ctx->fonts().instanceOf(font) };
+
+  // the font may be in another atlas page than the current font
+  const bool otherPage { instance &&
+    instance->ContainerAtlas->TexID != drawList->_CmdHeader.TextureId };
+  if(otherPage)
+    drawList->PushTextureID(instance->ContainerAtlas->TexID);
+  drawList->AddText(instance, font_size,
     pos, col_rgba, text, nullptr, API_RO_GET(wrap_width),
     cpu_fine_clip_rect_ptr);
+  if(otherPage)
+    drawList->PopTextureID();
 }
 
 static std::vector<ImVec2> makePointsArray(const reaper_array *points)
@@ -346,7 +368,7 @@ DEFINE_API(void, DrawList_AddImage, (ImGui_DrawList*,draw_list)
   Context *ctx;
   ImDrawList *dl { draw_list->get(&ctx) };
   assertValid(img);
-  dl->AddImage(img->makeTexture(ctx->textureManager()),
+  img->draw(dl, ctx->textureManager(),
     ImVec2(p_min_x, p_min_y), ImVec2(p_max_x, p_max_y),
     ImVec2(API_RO_GET(uv_min_x), API_RO_GET(uv_min_y)),
     ImVec2(API_RO_GET(uv_max_x), API_RO_GET(uv_max_y)),
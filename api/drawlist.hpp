@@ -27,6 +27,9 @@ struct DrawListProxy
     : public ResourceProxy<DrawListProxy, Context, ImDrawList> {
   static constexpr const char *api_type_name { "ImGui_DrawList" };
 
+  // fonts may be in another atlas page than the one the list started with
+  static void useFontTexture(ImDrawList *);
+
   using GetterFuncType = ImDrawList*(*)();
   template<Key KeyValue, GetterFuncType GetterFunc>
   struct Getter {
@@ -34,7 +37,9 @@ struct DrawListProxy
     static auto get(Context *ctx)
     {
       assertFrame(ctx);
-      return GetterFunc();
+      ImDrawList *drawList { GetterFunc() };
+      useFontTexture(drawList);
+      return drawList;
     }
   };
 
@@ -47,7 +52,9 @@ struct DrawListProxy
 
 using ImGui_DrawList = DrawListProxy;
 
-class DrawListSplitter : public Resource {
+class DrawListSplitter
+  : public TypedResource<DrawListSplitter, Resource,
+                         ResourceSubclass_DrawListSplitter> {
 public:
   static constexpr const char *api_type_name { "ImGui_DrawListSplitter" };
 
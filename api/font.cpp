@@ -24,18 +24,25 @@ R"(Supports loading fonts from the system by family name or from a file.
 Glyphs may contain colors in COLR/CPAL format.
 
 This API currently has multiple limitations (v1.0 blockers):
-- ReaImGui rasterizes glyphs only from the Basic Latin and Latin Supplement
-  Unicode blocks (U+0020 to U+00FF). UTF-8 is fully supported internally,
-  however characters outside those blocks are displayed as '?'.
+- ReaImGui rasterizes glyphs from the Basic Latin and Latin Supplement
+  Unicode blocks (U+0020 to U+00FF) upfront. Other characters are added to
+  attached fonts on demand once given to a function displaying them (labels,
+  text, formats, combo items and the contents of input fields), and are
+  displayed as '?' until the next defer cycle. The default font is limited to
+  the blocks above.
   See [issue #5](https://github.com/cfillion/reaimgui/issues/5).
 - Dear ImGui does not support using new fonts in the middle of a frame.
   Because of this, fonts must first be registered using Attach before any
   other context functions are used in the same defer cycle.
+  Fonts attached after the first frame are added to the existing atlas when
+  possible. Otherwise they are built in the background and rendered using
+  the default font until they become available.
   (Attaching a font is a heavy operation and should ideally be done outside
   of the defer loop.))");
 
 DEFINE_API(ImGui_Font*, CreateFont,
-(const char*,family_or_file)(int,size)(int*,API_RO(flags),ReaImGuiFontFlags_None),
+(const char*,family_or_file)(int,size)(int*,API_RO(flags),ReaImGuiFontFlags_None)
+(const char*,API_RO(glyphs)),
 R"(Load a font matching a font family name or from a font file.
 The font will remain valid while it's attached to a context. See Attach.
 
@@ -44,9 +51,35 @@ sans-serif, serif, monospace, cursive, fantasy.
 
 If 'family_or_file' specifies a path to a font file (contains a / or \):
 - The first byte of 'flags' is used as the font index within the file
-- The font styles in 'flags' are simulated by the font renderer)")
+- The font styles in 'flags' are simulated by the font renderer
+
+If 'glyphs' is set, only the characters it contains are rasterized upfront
+instead of the Basic Latin and Latin Supplement blocks. This reduces the
+build time and memory usage of fonts used for few characters (eg. digits
+in a large size). Other characters are added on demand.
+
+Fonts created with FontFlags_SDF are rasterized once as signed distance fields
+at a reference size, independently of 'size' and of the DPI scale. They remain
+sharp when drawn at any size (see DrawList_AddTextEx) or zoom level, at the
+cost of colored glyphs and of some sharpness in small sizes.)")
+{
+  nullIfEmpty(API_RO(glyphs));
+  return new Font { family_or_file, size, API_RO_GET(flags), API_RO(glyphs) };
+}
+
+DEFINE_API(void, GetFontAtlasStats, (ImGui_Context*,ctx)
+(double*,API_W(bytes))(double*,API_W(build_time)),
+R"(Size of the font atlas textures used by the context at every DPI scale,
+and the total time in seconds it took to build them (or to load them from the
+cache). Atlases are rebuilt when fonts are attached or detached.
+See CreateFont's 'glyphs' parameter.)")
 {
-  return new Font { family_or_file, size, API_RO_GET(flags) };
+  assertValid(ctx);
+  size_t bytes;
+  double buildTime;
+  ctx->fonts().stats(&bytes, &buildTime);
+  if(API_W(bytes))      *API_W(bytes)      = bytes;
+  if(API_W(build_time)) *API_W(build_time) = buildTime;
 }
 
 DEFINE_API(ImGui_Font*, GetFont, (ImGui_Context*,ctx),
@@ -83,3 +116,5 @@ applied.)")
 DEFINE_ENUM(ReaImGui, FontFlags_None,   "");
 DEFINE_ENUM(ReaImGui, FontFlags_Bold,   "");
 DEFINE_ENUM(ReaImGui, FontFlags_Italic, "");
+DEFINE_ENUM(ReaImGui, FontFlags_SDF,
+  "Render from a signed distance field. See CreateFont.");
@@ -21,6 +21,7 @@
 #include "../src/api.hpp"
 #include "../src/api_vararg.hpp"
 #include "../src/context.hpp"
+#include "../src/glyph_cache.hpp"
 
 #include <array>
 #include <boost/preprocessor/cat.hpp>
@@ -63,6 +64,14 @@ using DefArgVal = std::conditional_t<
   T, std::remove_pointer_t<T>
 >;
 
+// characters of displayed strings are rasterized on demand if missing from
+// the fonts (to be called by the functions displaying these arguments)
+template<typename... Strings>
+inline void requestGlyphs(const Strings... texts)
+{
+  (GlyphRequests::add(texts), ...);
+}
+
 #define _DEFARG_ID(argName) BOOST_PP_CAT(argName, Default)
 #define _DEFARG(r, name, i, arg)                         \
   BOOST_PP_EXPR_IF(                                      \
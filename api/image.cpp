@@ -20,10 +20,23 @@
 #include "../src/color.hpp"
 #include "../src/image.hpp"
 
+#include <imgui/imgui_internal.h> // ItemAdd, ItemSize
+#include <reaper_plugin_secrets.h> // reaper_array
+
 API_SECTION("Image",
-R"(ReaImGui currently supports loading PNG and JPEG bitmap images.
+R"(ReaImGui currently supports loading PNG, JPEG and QOI bitmap images as well
+as uncompressed RGBA pixels prefixed with a 16-byte header ("rgba\r\n\x1a\n"
+followed by the width and height as big-endian 32-bit integers). QOI and raw
+RGBA files decode much faster than PNG at the cost of a larger file size.
 Flat vector images may be loaded as fonts, see CreateFont.
 
+Images larger than 8192 pixels in either dimension are split into tiles.
+Only a copy downscaled to fit within 2048x2048 is kept in memory. Image and
+DrawList_AddImage decode the visible tiles at full resolution from the file
+(or from the data given to CreateImageFromMem) in the background, showing the
+downscaled copy until they are ready. Image sets do not generate scaled
+copies of tiled images.
+
 UV parameters are texture coordinates in a scale of 0.0 (top/left) to 1.0
 (bottom/right). Use values below 0.0 or above 1.0 to tile the image.
 
@@ -32,22 +45,42 @@ DrawList_AddImageQuad and DrawList_AddImageRounded.)");
 
 // TODO: Attach/Detach API
 DEFINE_API(ImGui_Image*, CreateImage,
-(const char*,file)(int*,API_RO(flags)),
+(const char*,file)(int*,API_RO(flags),ReaImGuiImageFlags_None)
+(int*,API_RO(max_w),0)(int*,API_RO(max_h),0),
 R"(The returned object is valid as long as it is used in each defer cycle
 unless attached to a context (see Attach).
 
-('flags' currently unused and reserved for future expansion))")
+With ImageFlags_Async, only the header of the file is read immediately and the
+pixels are decoded in the background. The image has its final size but is
+drawn transparent until loading completes. See Image_IsLoaded. Rows are shown
+from the top as they are decoded, except for interlaced PNG images.
+
+Give max_w and/or max_h to downscale large images to fit within that size
+while loading (preserving the aspect ratio, 0 = unlimited). JPEG images are
+decoded directly at a reduced size, making this much faster and lighter on
+memory than loading at full resolution when only a thumbnail is needed.
+
+With ImageFlags_ReleasePixels, the decoded pixels are freed from memory once
+every window using the image has uploaded them to the GPU. They are decoded
+again from the file in the background if needed later (eg. when the image
+appears in a new window). See GetImageMemoryUsage and Image_IsLoaded.)")
 {
-  return Image::fromFile(file);
+  const int maxWidth { API_RO_GET(max_w) }, maxHeight { API_RO_GET(max_h) };
+  if(maxWidth < 0 || maxHeight < 0)
+    throw reascript_error { "maximum size must be positive" };
+  return Image::fromFile(file, API_RO_GET(flags), maxWidth, maxHeight);
 }
 
 DEFINE_API(ImGui_Image*, CreateImageFromMem,
-(const char*,data)(int,data_sz),
+(const char*,data)(int,data_sz)(int*,API_RO(flags),ReaImGuiImageFlags_None),
 R"(Requires REAPER v6.44 or newer for EEL and Lua. Load from a file using
-CreateImage or explicitely specify data_sz if supporting older versions.)")
+CreateImage or explicitely specify data_sz if supporting older versions.
+
+ImageFlags_ReleasePixels keeps a copy of the encoded data to decode it again
+when needed. ImageFlags_Async is not supported.)")
 {
   // data_sz is inaccurate before REAPER 6.44
-  return Image::fromMemory(data, data_sz);
+  return Image::fromMemory(data, data_sz, API_RO_GET(flags));
 }
 
 DEFINE_API(void, Image_GetSize, (ImGui_Image*,img)
@@ -59,6 +92,29 @@ DEFINE_API(void, Image_GetSize, (ImGui_Image*,img)
   if(API_W(h)) *API_W(h) = img->height();
 }
 
+DEFINE_API(void, GetImageMemoryUsage,
+(double*,API_W(resident_bytes))(double*,API_W(released_bytes)),
+R"(Total size of the decoded pixels of all images that are currently held in
+memory (including those only kept for reuse by future images), and of those
+freed after being uploaded (see ImageFlags_ReleasePixels).
+Images sharing the same pixels are counted separately.)")
+{
+  size_t resident, released;
+  Bitmap::memoryUsage(&resident, &released);
+  if(API_W(resident_bytes)) *API_W(resident_bytes) = resident;
+  if(API_W(released_bytes)) *API_W(released_bytes) = released;
+}
+
+DEFINE_API(bool, Image_IsLoaded, (ImGui_Image*,img),
+R"(Whether the pixels of an image created with ImageFlags_Async (or being
+decoded again after ImageFlags_ReleasePixels freed them) have finished
+decoding. Raises the decoding error if loading failed.
+Image sets are loaded when all of their images are.)")
+{
+  assertValid(img);
+  return img->isLoaded();
+}
+
 DEFINE_API(void, Image, (ImGui_Context*,ctx)
 (ImGui_Image*,img)(double,size_w)(double,size_h)
 (double*,API_RO(uv0_x),0.0)(double*,API_RO(uv0_y),0.0)
@@ -69,11 +125,31 @@ DEFINE_API(void, Image, (ImGui_Context*,ctx)
   FRAME_GUARD;
   assertValid(img);
 
-  const ImTextureID tex { img->makeTexture(ctx->textureManager()) };
-  ImGui::Image(tex, ImVec2(size_w, size_h),
+  // same as ImGui::Image, letting large images draw themselves in tiles
+  ImGuiWindow *window { ImGui::GetCurrentWindow() };
+  if(window->SkipItems)
+    return;
+
+  const ImVec4 tintCol   { Color(API_RO_GET(tint_col_rgba))   },
+               borderCol { Color(API_RO_GET(border_col_rgba)) };
+  const ImVec2 &pos { window->DC.CursorPos };
+  const float border { borderCol.w > 0.f ? 2.f : 0.f };
+  ImRect bb { pos.x, pos.y,
+    static_cast<float>(pos.x + size_w + border),
+    static_cast<float>(pos.y + size_h + border) };
+  ImGui::ItemSize(bb);
+  if(!ImGui::ItemAdd(bb, 0))
+    return;
+
+  if(borderCol.w > 0.f) {
+    window->DrawList->AddRect(bb.Min, bb.Max, ImGui::GetColorU32(borderCol));
+    bb.Expand(-1.f);
+  }
+
+  img->draw(window->DrawList, ctx->textureManager(), bb.Min, bb.Max,
     ImVec2(API_RO_GET(uv0_x), API_RO_GET(uv0_y)),
     ImVec2(API_RO_GET(uv1_x), API_RO_GET(uv1_y)),
-    Color(API_RO_GET(tint_col_rgba)), Color(API_RO_GET(border_col_rgba)));
+    ImGui::GetColorU32(tintCol));
 }
 
 DEFINE_API(bool, ImageButton, (ImGui_Context*,ctx)
@@ -93,10 +169,57 @@ DEFINE_API(bool, ImageButton, (ImGui_Context*,ctx)
     Color(API_RO_GET(bg_col_rgba)), Color(API_RO_GET(tint_col_rgba)));
 }
 
+API_SUBSECTION("Pixel Image",
+R"(Image created from raw pixel values instead of an encoded file, for
+visuals generated by the script (spectrograms, meters...). Writing to a
+region of the image only updates that region of the existing GPU textures.
+
+ImGui_PixelImage objects can be given to any function that expect an image as
+parameter.)");
+
+DEFINE_API(ImGui_PixelImage*, CreatePixelImage, (int,width)(int,height),
+R"(The image is initially fully transparent.
+The returned object is valid as long as it is used in each defer cycle
+unless attached to a context (see Attach).)")
+{
+  return new PixelImage { width, height };
+}
+
+DEFINE_API(void, PixelImage_SetPixels, (ImGui_PixelImage*,img)
+(int,x)(int,y)(int,w)(int,h)(reaper_array*,pixels)
+(int*,API_RO(pixels_offset),0),
+R"(Replace the pixels of a rectangular area of the image.
+Pixels are 0xRRGGBBAA values ordered row by row, starting at pixels_offset.
+Values outside of the 32-bit range are clamped and NaN is transparent.)")
+{
+  assertValid(img);
+  assertValid(pixels);
+  const int offset { API_RO_GET(pixels_offset) };
+  if(offset < 0 || static_cast<unsigned int>(offset) > pixels->size)
+    throw reascript_error { "offset is out of bounds" };
+  img->write(x, y, w, h, pixels->data + offset, pixels->size - offset);
+}
+
+DEFINE_API(void, PixelImage_SetPixelsFromMem, (ImGui_PixelImage*,img)
+(int,x)(int,y)(int,w)(int,h)(const char*,data)(int,data_sz),
+R"(Replace the pixels of a rectangular area of the image.
+The data consists of rows of 4 bytes (red, green, blue, alpha) per pixel.)")
+{
+  assertValid(img);
+  if(data_sz < 0)
+    throw reascript_error { "invalid size" };
+  img->write(x, y, w, h, reinterpret_cast<const unsigned char *>(data), data_sz);
+}
+
 API_SUBSECTION("Image Set",
 R"(Helper to automatically select and scale an image to the DPI scale of
 the current window upon usage.
 
+When none of the images in the set is close to the current DPI scale, a
+downscaled copy of the next larger image is generated for that scale.
+Providing a single high resolution image is therefore enough for sharp
+rendering at lower scales.
+
 ImGui_ImageSet objects can be given to any function that expect an image as
 parameter.
 
@@ -125,3 +248,9 @@ DEFINE_API(void, ImageSet_Add, (ImGui_ImageSet*,set)
   assertValid(img);
   set->add(scale, img);
 }
+
+DEFINE_ENUM(ReaImGui, ImageFlags_None,  "");
+DEFINE_ENUM(ReaImGui, ImageFlags_Async,
+  "Decode the image in the background. See CreateImage.");
+DEFINE_ENUM(ReaImGui, ImageFlags_ReleasePixels,
+  "Free the decoded pixels from memory once uploaded to the GPU.");
@@ -65,6 +65,7 @@ DEFINE_API(bool, InputText, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RWBIG(buf));
   assertValid(API_RWBIG(buf));
 
   std::string value { API_RWBIG(buf) };
@@ -88,6 +89,7 @@ DEFINE_API(bool, InputTextMultiline, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RWBIG(buf));
   assertValid(API_RWBIG(buf));
 
   std::string value { API_RWBIG(buf) };
@@ -108,6 +110,7 @@ DEFINE_API(bool, InputTextWithHint, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, hint, API_RWBIG(buf));
   assertValid(API_RWBIG(buf));
 
   std::string value { API_RWBIG(buf) };
@@ -126,6 +129,7 @@ DEFINE_API(bool, InputInt, (ImGui_Context*,ctx)(const char*,label)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
 
   const InputTextFlags flags { API_RO_GET(flags) };
   return ImGui::InputInt(label, API_RW(v),
@@ -137,6 +141,7 @@ DEFINE_API(bool, InputInt2, (ImGui_Context*,ctx)(const char*,label)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
 
   ReadWriteArray<int, int, 2> values { API_RW(v1), API_RW(v2) };
   const InputTextFlags flags { API_RO_GET(flags) };
@@ -153,6 +158,7 @@ DEFINE_API(bool, InputInt3, (ImGui_Context*,ctx)(const char*,label)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
 
   ReadWriteArray<int, int, 3> values { API_RW(v1), API_RW(v2), API_RW(v3) };
   const InputTextFlags flags { API_RO_GET(flags) };
@@ -169,6 +175,7 @@ DEFINE_API(bool, InputInt4, (ImGui_Context*,ctx)(const char*,label)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
 
   ReadWriteArray<int, int, 4> values
     { API_RW(v1), API_RW(v2), API_RW(v3), API_RW(v4) };
@@ -186,6 +193,7 @@ DEFINE_API(bool, InputDouble, (ImGui_Context*,ctx)(const char*,label)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   const InputTextFlags flags { API_RO_GET(flags) };
@@ -207,6 +215,7 @@ DEFINE_API(bool, InputDouble2, (ImGui_Context*,ctx)(const char*,label)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   ReadWriteArray<double, double, 2> values { API_RW(v1), API_RW(v2) };
@@ -224,6 +233,7 @@ DEFINE_API(bool, InputDouble3, (ImGui_Context*,ctx)(const char*,label)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   ReadWriteArray<double, double, 3> values { API_RW(v1), API_RW(v2), API_RW(v3) };
@@ -241,6 +251,7 @@ DEFINE_API(bool, InputDouble4, (ImGui_Context*,ctx)(const char*,label)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   ReadWriteArray<double, double, 4> values
@@ -259,6 +270,7 @@ DEFINE_API(bool, InputDoubleN, (ImGui_Context*,ctx)(const char*,label)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   assertValid(values);
   nullIfEmpty(API_RO(format));
 
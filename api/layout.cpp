@@ -32,6 +32,7 @@ DEFINE_API(void, SeparatorText, (ImGui_Context*,ctx)
 "Text formatted with an horizontal line")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   ImGui::SeparatorText(label);
 }
 
@@ -20,7 +20,8 @@
 
 #include "../src/resource.hpp"
 
-class ListClipper final : public Resource {
+class ListClipper final
+  : public TypedResource<ListClipper, Resource, ResourceSubclass_ListClipper> {
 public:
   static constexpr const char *api_type_name { "ImGui_ListClipper" };
 
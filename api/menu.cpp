@@ -39,6 +39,7 @@ DEFINE_API(bool, BeginMenu, (ImGui_Context*,ctx)
 "Create a sub-menu entry. only call EndMenu if this returns true!")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   return ImGui::BeginMenu(label, API_RO_GET(enabled));
 }
 
@@ -57,6 +58,7 @@ processed by ImGui at the moment. Toggle state is written to 'selected' when
 provided.)")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(shortcut));
   nullIfEmpty(API_RO(shortcut));
 
   return ImGui::MenuItem(label, API_RO(shortcut), API_RWO(p_selected),
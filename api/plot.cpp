@@ -35,6 +35,7 @@ DEFINE_API(void, PlotLines, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(overlay_text));
   assertValid(values);
   nullIfEmpty(API_RO(overlay_text));
 
@@ -52,6 +53,7 @@ DEFINE_API(void, PlotHistogram, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(overlay_text));
   assertValid(values);
   nullIfEmpty(API_RO(overlay_text));
 
@@ -55,6 +55,7 @@ dimming background, has a title bar. Return true if the modal is open, and you
 can start outputting to it. See BeginPopup.)")
 {
   FRAME_GUARD;
+  requestGlyphs(name);
   WindowFlags flags { API_RO_GET(flags) };
   return ImGui::BeginPopupModal(name, openPtrBehavior(API_RWO(p_open)), flags);
 }
@@ -211,5 +212,6 @@ R"(Set a text-only tooltip, typically use with IsItemHovered. override any
 previous call to SetTooltip.)")
 {
   FRAME_GUARD;
+  requestGlyphs(text);
   ImGui::SetTooltip("%s", text);
 }
@@ -48,6 +48,7 @@ R"(The BeginCombo/EndCombo API allows you to manage your contents and selection
 state however you want it, by creating e.g. Selectable items.)")
 {
   FRAME_GUARD;
+  requestGlyphs(label, preview_value);
 
   return ImGui::BeginCombo(label, preview_value, API_RO_GET(flags));
 }
@@ -68,6 +69,9 @@ null-terminated (requires REAPER v6.44 or newer for EEL and Lua).)")
   FRAME_GUARD;
 
   const auto &strings { splitList(items, items_sz) };
+  requestGlyphs(label);
+  for(const char *item : strings)
+    requestGlyphs(item);
   return ImGui::Combo(label, API_RW(current_item),
     strings.data(), strings.size(), API_RO_GET(popup_max_height_in_items));
 }
@@ -99,6 +103,9 @@ Each item must be null-terminated (requires REAPER v6.44 or newer for EEL and Lu
   FRAME_GUARD;
 
   const auto &strings { splitList(items, items_sz) };
+  requestGlyphs(label);
+  for(const char *item : strings)
+    requestGlyphs(item);
   return ImGui::ListBox(label, API_RW(current_item),
     strings.data(), strings.size(), API_RO_GET(height_in_items));
 }
@@ -123,6 +130,7 @@ state however you want it, by creating e.g. Selectable or any items.
 See EndListBox.)")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   const ImVec2 size(API_RO_GET(size_w), API_RO_GET(size_h));
   return ImGui::BeginListBox(label, size);
 }
@@ -147,6 +155,7 @@ DEFINE_API(bool, Selectable, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   bool selectedOmitted {};
   bool *selected { API_RW(p_selected) ? API_RW(p_selected) : &selectedOmitted };
   const ImVec2 size (API_RO_GET(size_w), API_RO_GET(size_h));
@@ -61,6 +61,7 @@ DEFINE_API(bool, DragInt, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   return ImGui::DragInt(label, API_RW(v), API_RO_GET(v_speed),
@@ -76,6 +77,7 @@ DEFINE_API(bool, DragInt2, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   ReadWriteArray<int, int, 2> values { API_RW(v1), API_RW(v2) };
@@ -96,6 +98,7 @@ DEFINE_API(bool, DragInt3, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   ReadWriteArray<int, int, 3> values { API_RW(v1), API_RW(v2), API_RW(v3) };
@@ -116,6 +119,7 @@ DEFINE_API(bool, DragInt4, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   ReadWriteArray<int, int, 4> values
@@ -137,6 +141,7 @@ DEFINE_API(bool, DragIntRange2, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format), API_RO(format_max));
   nullIfEmpty(API_RO(format));
   nullIfEmpty(API_RO(format_max));
 
@@ -160,6 +165,7 @@ DEFINE_API(bool, DragFloatRange2, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format), API_RO(format_max));
   nullIfEmpty(API_RO(format));
   nullIfEmpty(API_RO(format_max));
 
@@ -182,6 +188,7 @@ DEFINE_API(bool, DragDouble, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   const double v_min { API_RO_GET(v_min) }, v_max { API_RO_GET(v_max) };
@@ -205,6 +212,7 @@ DEFINE_API(bool, DragDouble2, (ImGui_Context*,ctx)(const char*,label)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   ReadWriteArray<double, double, 2> values { API_RW(v1), API_RW(v2) };
@@ -224,6 +232,7 @@ DEFINE_API(bool, DragDouble3, (ImGui_Context*,ctx)(const char*,label)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   ReadWriteArray<double, double, 3> values { API_RW(v1), API_RW(v2), API_RW(v3) };
@@ -244,6 +253,7 @@ DEFINE_API(bool, DragDouble4, (ImGui_Context*,ctx)(const char*,label)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   ReadWriteArray<double, double, 4> values
@@ -264,6 +274,7 @@ DEFINE_API(bool, DragDoubleN, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   assertValid(values);
   nullIfEmpty(API_RO(format));
 
@@ -280,6 +291,7 @@ DEFINE_API(bool, SliderInt, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   return ImGui::SliderInt(label, API_RW(v), v_min, v_max,
@@ -292,6 +304,7 @@ DEFINE_API(bool, SliderInt2, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   ReadWriteArray<int, int, 2> values { API_RW(v1), API_RW(v2) };
@@ -310,6 +323,7 @@ DEFINE_API(bool, SliderInt3, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   ReadWriteArray<int, int, 3> values { API_RW(v1), API_RW(v2), API_RW(v3) };
@@ -328,6 +342,7 @@ DEFINE_API(bool, SliderInt4, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   ReadWriteArray<int, int, 4> values
@@ -346,6 +361,7 @@ DEFINE_API(bool, SliderDouble, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   return ImGui::SliderScalar(label, ImGuiDataType_Double, API_RW(v),
@@ -367,6 +383,7 @@ DEFINE_API(bool, SliderDouble2, (ImGui_Context*,ctx)(const char*,label)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   ReadWriteArray<double, double, 2> values { API_RW(v1), API_RW(v2) };
@@ -385,6 +402,7 @@ DEFINE_API(bool, SliderDouble3, (ImGui_Context*,ctx)(const char*,label)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   ReadWriteArray<double, double, 3> values { API_RW(v1), API_RW(v2), API_RW(v3) };
@@ -403,6 +421,7 @@ DEFINE_API(bool, SliderDouble4, (ImGui_Context*,ctx)(const char*,label)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   ReadWriteArray<double, double, 4> values
@@ -422,6 +441,7 @@ DEFINE_API(bool, SliderDoubleN, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   assertValid(values);
   nullIfEmpty(API_RO(format));
 
@@ -437,6 +457,7 @@ DEFINE_API(bool, SliderAngle, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   assertValid(API_RW(v_rad));
   nullIfEmpty(API_RO(format));
 
@@ -458,6 +479,7 @@ DEFINE_API(bool, VSliderInt, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   return ImGui::VSliderInt(label, ImVec2(size_w, size_h), API_RW(v),
@@ -471,6 +493,7 @@ DEFINE_API(bool, VSliderDouble, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(label, API_RO(format));
   nullIfEmpty(API_RO(format));
 
   return ImGui::VSliderScalar(label, ImVec2(size_w, size_h),
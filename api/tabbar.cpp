@@ -65,6 +65,7 @@ R"(Create a Tab. Returns true if the Tab is selected.
 Set 'p_open' to true to enable the close button.)")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   return ImGui::BeginTabItem(label,
     openPtrBehavior(API_RWO(p_open)), API_RO_GET(flags));
 }
@@ -82,6 +83,7 @@ R"(Create a Tab behaving like a button. Return true when clicked.
 Cannot be selected in the tab bar.)")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   return ImGui::TabItemButton(label, API_RO_GET(flags));
 }
 
@@ -144,6 +144,7 @@ R"(Use to specify label, resizing policy, default width/weight, id,
 various other flags etc.)")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   ImGui::TableSetupColumn(label, API_RO_GET(flags),
     API_RO_GET(init_width_or_weight), API_RO_GET(user_id));
 }
@@ -169,6 +170,7 @@ DEFINE_API(void, TableHeader, (ImGui_Context*,ctx)
 "Submit one header cell manually (rarely used). See TableSetupColumn.")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   ImGui::TableHeader(label);
 }
 
@@ -18,6 +18,8 @@
 #include "helper.hpp"
 
 #include "../src/color.hpp"
+#include "../src/font.hpp"
+#include "../src/text_cache.hpp"
 
 API_SECTION("Text");
 
@@ -26,6 +28,7 @@ DEFINE_API(void, Text, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(text);
   ImGui::TextUnformatted(text);
 }
 
@@ -34,6 +37,7 @@ DEFINE_API(void, TextColored, (ImGui_Context*,ctx)
 "Shortcut for PushStyleColor(Col_Text, color); Text(text); PopStyleColor();")
 {
   FRAME_GUARD;
+  requestGlyphs(text);
 
   ImVec4 color { Color(col_rgba) };
   ImGui::PushStyleColor(ImGuiCol_Text, color);
@@ -46,6 +50,7 @@ DEFINE_API(void, TextDisabled, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(text);
   const ImGuiStyle &style { ImGui::GetStyle() };
   ImGui::PushStyleColor(ImGuiCol_Text, style.Colors[ImGuiCol_TextDisabled]);
   ImGui::TextUnformatted(text);
@@ -60,6 +65,7 @@ widgets to extend the window width, yoy may need to set a size using
 SetNextWindowSize.)")
 {
   FRAME_GUARD;
+  requestGlyphs(text);
   ImGui::PushTextWrapPos(0.0f);
   ImGui::TextUnformatted(text);
   ImGui::PopTextWrapPos();
@@ -70,6 +76,7 @@ DEFINE_API(void, LabelText, (ImGui_Context*,ctx)
 "Display text+label aligned the same way as value+label widgets")
 {
   FRAME_GUARD;
+  requestGlyphs(label, text);
   ImGui::LabelText(label, "%s", text);
 }
 
@@ -87,6 +94,7 @@ DEFINE_API(void, BulletText, (ImGui_Context*,ctx)
 "Shortcut for Bullet + Text.")
 {
   FRAME_GUARD;
+  requestGlyphs(text);
   ImGui::Bullet();
   ImGui::TextUnformatted(text);
 }
@@ -156,12 +164,38 @@ DEFINE_API(void, CalcTextSize, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
-  const ImVec2 &size {
-    ImGui::CalcTextSize(text, nullptr,
-      API_RO_GET(hide_text_after_double_hash), API_RO_GET(wrap_width))
-  };
-  if(API_W(w)) *API_W(w) = size.x;
-  if(API_W(h)) *API_W(h) = size.y;
+  requestGlyphs(text);
+
+  // measuring long strings every frame is slow
+  TextCache &cache { ctx->textCache() };
+  cache.setVersion(ctx->fonts().version());
+  const TextCache::Key key { ImGui::GetFont(), ImGui::GetFontSize(),
+    static_cast<float>(API_RO_GET(wrap_width)),
+    API_RO_GET(hide_text_after_double_hash), text };
+  TextCache::Size size;
+  if(!cache.find(key, &size)) {
+    const ImVec2 &measured {
+      ImGui::CalcTextSize(text, nullptr,
+        key.hideAfterDoubleHash, key.wrapWidth)
+    };
+    size = { measured.x, measured.y };
+    cache.insert(key, size);
+  }
+
+  if(API_W(w)) *API_W(w) = size.width;
+  if(API_W(h)) *API_W(h) = size.height;
+}
+
+DEFINE_API(void, GetTextSizeCacheStats, (ImGui_Context*,ctx)
+(int*,API_W(hits))(int*,API_W(misses)),
+R"(Number of CalcTextSize calls answered from the context's cache of measured
+strings, and of those that had to measure the text. The cache is cleared
+when fonts are attached, detached or receive new glyphs.)")
+{
+  assertValid(ctx);
+  const TextCache &cache { ctx->textCache() };
+  if(API_W(hits))   *API_W(hits)   = cache.hits();
+  if(API_W(misses)) *API_W(misses) = cache.misses();
 }
 
 DEFINE_API(void, DebugTextEncoding, (ImGui_Context*,ctx)
@@ -170,5 +204,6 @@ R"(Helper tool to diagnose between text encoding issues and font loading issues.
 Pass your UTF-8 string and verify that there are correct.)")
 {
   FRAME_GUARD;
+  requestGlyphs(text);
   ImGui::DebugTextEncoding(text);
 }
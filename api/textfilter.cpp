@@ -76,6 +76,7 @@ DEFINE_API(bool, TextFilter_Draw, (ImGui_TextFilter*,filter)
 {
   assertValid(filter);
   FRAME_GUARD;
+  requestGlyphs(API_RO(label), (*filter)->InputBuf);
 
   return (*filter)->Draw(API_RO_GET(label), API_RO_GET(width));
 }
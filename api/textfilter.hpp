@@ -20,7 +20,8 @@
 
 #include "../src/resource.hpp"
 
-class TextFilter : public Resource {
+class TextFilter
+  : public TypedResource<TextFilter, Resource, ResourceSubclass_TextFilter> {
 public:
   static constexpr const char *api_type_name { "ImGui_TextFilter" };
 
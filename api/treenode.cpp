@@ -25,6 +25,7 @@ R"(TreeNode functions return true when the node is open, in which case you need
 to also call TreePop when you are finished displaying the tree node contents.)")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   return ImGui::TreeNodeEx(label, API_RO_GET(flags));
 }
 
@@ -36,6 +37,7 @@ Read the [FAQ](https://dearimgui.org/faq) about why and how to use ID.
 To align arbitrary text at the same level as a TreeNode you can use Bullet.)")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   return ImGui::TreeNodeEx(str_id, API_RO_GET(flags), "%s", label);
 }
 
@@ -78,6 +80,7 @@ on upper right of the header which will set the bool to false when clicked,
 if 'false' don't display the header.)")
 {
   FRAME_GUARD;
+  requestGlyphs(label);
   // p_visible behavior differs from ImGui: false as input is treated the same
   // as NULL. This is because EEL doesn't have a NULL (0 = false), API_W never
   // receives a NULL, and API_RWO aren't listed in the output values list.
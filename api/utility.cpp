@@ -65,6 +65,7 @@ Supported types are:
 - ImGui_Image*
 - ImGui_ImageSet*
 - ImGui_ListClipper*
+- ImGui_PixelImage*
 - ImGui_TextFilter*
 - ImGui_Viewport*)")
 {
@@ -75,6 +76,7 @@ Supported types are:
   RESOURCE_ISVALID(Image);
   RESOURCE_ISVALID(ImageSet);
   RESOURCE_ISVALID(ListClipper);
+  RESOURCE_ISVALID(PixelImage);
   RESOURCE_ISVALID(TextFilter);
 
   RESOURCEPROXY_ISVALID(DrawListProxy);
@@ -86,6 +88,18 @@ Supported types are:
 #undef RESOURCE_ISVALID
 #undef RESOURCEPROXY_ISVALID
 
+DEFINE_API(void, GetResourceStats, (int*,API_W(live))(int*,API_W(collected)),
+R"(Number of objects (contexts, fonts, images, etc) currently alive and the
+total number of objects destroyed after being left unused. Unused objects are
+destroyed in the background over multiple defer cycles when there are many of
+them. See ValidatePtr.)")
+{
+  size_t live, collected;
+  Resource::stats(&live, &collected);
+  if(API_W(live))      *API_W(live)      = live;
+  if(API_W(collected)) *API_W(collected) = collected;
+}
+
 DEFINE_API(void, ProgressBar, (ImGui_Context*,ctx)
 (double,fraction)
 (double*,API_RO(size_arg_w),-FLT_MIN)(double*,API_RO(size_arg_h),0.0)
@@ -93,6 +107,7 @@ DEFINE_API(void, ProgressBar, (ImGui_Context*,ctx)
 "")
 {
   FRAME_GUARD;
+  requestGlyphs(API_RO(overlay));
   nullIfEmpty(API_RO(overlay));
   const ImVec2 size(API_RO_GET(size_arg_w), API_RO_GET(size_arg_h));
   ImGui::ProgressBar(fraction, size, API_RO(overlay));
@@ -73,6 +73,7 @@ R"(Push window to the stack and start appending to it.
   so you may early out and omit submitting anything to the window.)")
 {
   FRAME_GUARD;
+  requestGlyphs(name);
 
   WindowFlags flags { API_RO_GET(flags) };
   DecorationBehavior dec { ctx, *flags };
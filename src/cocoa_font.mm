@@ -109,7 +109,7 @@ static NSURL *findMatchingFile(NSDictionary *attrs)
     ((__bridge CTFontDescriptorRef)match, kCTFontURLAttribute);
 }
 
-bool Font::resolve(const char *family, const int style)
+bool Font::resolve(const char *family, const int style, Source *source)
 {
   const int traits { styleToTraits(style) };
   family = translateGenericFont(family);
@@ -129,7 +129,7 @@ bool Font::resolve(const char *family, const int style)
       return false;
   }
 
-  m_data = [[url path] UTF8String];
-  std::tie(m_index, m_missingStyles) = findClosestMatch(url, style);
+  source->data = [[url path] UTF8String];
+  std::tie(source->index, source->missingStyles) = findClosestMatch(url, style);
   return true;
 }
@@ -23,6 +23,7 @@
 #include "platform.hpp"
 #include "renderer.hpp"
 #include "settings.hpp"
+#include "text_cache.hpp"
 #include "texture.hpp"
 #include "viewport.hpp"
 #include "window.hpp"
@@ -42,10 +43,13 @@ enum DropState { DropState_None = -2, DropState_Drop = -1 };
 constexpr ImGuiMouseButton DND_MouseButton { ImGuiMouseButton_Left };
 constexpr ImGuiConfigFlags PRIVATE_CONFIG_FLAGS
   { ImGuiConfigFlags_ViewportsEnable };
+constexpr size_t TEXT_CACHE_SIZE { 1024 }; // entries
 
 static ImFontAtlas * const NO_DEFAULT_ATLAS
   { reinterpret_cast<ImFontAtlas *>(-1) };
 
+REAIMGUI_CONTEXT_TLS ImGuiContext *ReaImGui_CurrentContext; // see imconfig.h
+
 class TempCurrent {
 public:
   TempCurrent(Context *ctx)
@@ -92,7 +96,9 @@ Context::Context(const char *label, const int userConfigFlags)
     m_imgui           { ImGui::CreateContext(NO_DEFAULT_ATLAS)             },
     m_dockers         { std::make_unique<DockerList>()                     },
     m_textureManager  { std::make_unique<TextureManager>()                 },
-    m_fonts           { std::make_unique<FontList>(m_textureManager.get()) },
+    m_fonts           { std::make_unique<FontList>(m_imgui.get(),
+                                                   m_textureManager.get()) },
+    m_textCache       { std::make_unique<TextCache>(TEXT_CACHE_SIZE)       },
     m_rendererFactory { std::make_unique<RendererFactory>()                }
 {
   static const std::string logFn
@@ -120,6 +126,8 @@ Context::Context(const char *label, const int userConfigFlags)
   Renderer::install();
   Viewport::install();
 
+  enableHeartbeat();
+
   // prevent imgui from loading settings but not from saving them
   // (so that the saved state is reset to defaults)
   if(Settings::NoSavedSettings)
@@ -168,7 +176,7 @@ void Context::attach(Resource *obj)
   else if(!obj->attachable(this))
     throw reascript_error { "the object cannot be attached to this context" };
 
-  if(Font *font { dynamic_cast<Font *>(obj) }) {
+  if(Font *font { obj->as<Font>() }) {
     assertOutOfFrame();
     m_fonts->add(font);
   }
@@ -182,7 +190,7 @@ void Context::detach(Resource *obj)
   if(it == m_attachments.end())
     throw reascript_error { "the object is not attached to this context" };
 
-  if(Font *font { dynamic_cast<Font *>(obj) }) {
+  if(Font *font { obj->as<Font>() }) {
     assertOutOfFrame();
     m_fonts->remove(font);
   }
@@ -248,8 +256,10 @@ bool Context::enterFrame()
 {
   setCurrent();
 
-  if(m_imgui->WithinFrameScope)
+  if(m_imgui->WithinFrameScope) {
+    m_fonts->bindTexture(); // the atlas may be shared with other contexts
     return true;
+  }
   else
     return beginFrame();
 }
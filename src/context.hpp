@@ -35,6 +35,7 @@
 class DockerList;
 class FontList;
 class RendererFactory;
+class TextCache;
 class TextureManager;
 struct ImGuiContext;
 struct ImGuiViewport;
@@ -45,7 +46,8 @@ enum ConfigFlags {
 
 constexpr const char *REAIMGUI_PAYLOAD_TYPE_FILES { "_FILES" };
 
-class Context final : public Resource {
+class Context final
+  : public TypedResource<Context, Resource, ResourceSubclass_Context> {
 public:
   static constexpr const char *api_type_name { "ImGui_Context" };
   static Context *current();
@@ -78,6 +80,7 @@ public:
   ImGuiIO &IO();
   DockerList &dockers() { return *m_dockers; }
   FontList &fonts() { return *m_fonts; }
+  TextCache &textCache() { return *m_textCache; }
   HCURSOR cursor() const { return m_cursor; }
   ImGuiContext *imgui() const { return m_imgui.get(); }
   TextureManager *textureManager() const { return m_textureManager.get(); }
@@ -119,6 +122,7 @@ private:
   std::unique_ptr<DockerList> m_dockers;
   std::unique_ptr<TextureManager> m_textureManager;
   std::unique_ptr<FontList> m_fonts;
+  std::unique_ptr<TextCache> m_textCache;
   std::unique_ptr<RendererFactory> m_rendererFactory;
 };
 
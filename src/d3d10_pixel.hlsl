@@ -4,11 +4,22 @@ struct PS_INPUT {
   float2 uv  : TEXCOORD0;
 };
 
+cbuffer PIXEL_BUFFER : register(b0) {
+  int Format; // see Texture::Format
+};
+
 sampler sampler0;
 Texture2D texture0;
 
 float4 main(PS_INPUT input) : SV_Target
 {
-  float4 out_col = input.col * texture0.Sample(sampler0, input.uv);
+  float4 texel = texture0.Sample(sampler0, input.uv);
+  if(Format == 1) // single channel font atlas
+    texel = float4(1.f, 1.f, 1.f, texel.r);
+  else if(Format == 2) { // signed distance field, edges at 0.5
+    float width = max(fwidth(texel.r) * .5f, 1.f / 255.f);
+    texel = float4(1.f, 1.f, 1.f, smoothstep(.5f - width, .5f + width, texel.r));
+  }
+  float4 out_col = input.col * texel;
   return out_col;
 }
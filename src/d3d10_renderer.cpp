@@ -25,6 +25,7 @@
 #include <atlbase.h>
 #include <d3d10.h>
 #include <imgui/imgui.h>
+#include <optional>
 #include <vector>
 
 class D3D10Renderer;
@@ -40,6 +41,12 @@ constexpr uint8_t PIXEL_SHADER[] {
 
 enum Buffers { ConstantBuf, VertexBuf, IndexBuf, };
 
+static DXGI_FORMAT dxgiFormat(const Texture::Format format)
+{
+  return format == Texture::RGBA8 ? DXGI_FORMAT_R8G8B8A8_UNORM
+                                  : DXGI_FORMAT_R8_UNORM;
+}
+
 class D3D10Renderer final : public Renderer {
 public:
   D3D10Renderer(RendererFactory *, Window *);
@@ -65,9 +72,12 @@ private:
     CComPtr<ID3D10RasterizerState> m_rasterizerState;
     CComPtr<ID3D10DepthStencilState> m_depthStencilState;
     CComPtr<ID3D10SamplerState> m_samplerState;
+    // pixel shader constants for each Texture::Format
+    std::array<CComPtr<ID3D10Buffer>, 3> m_formatBuffers;
 
     TextureCookie m_cookie;
     std::vector<CComPtr<ID3D10ShaderResourceView>> m_textures;
+    std::vector<Texture::Format> m_formats;
   };
 
   struct Buffer {
@@ -198,6 +208,19 @@ D3D10Renderer::Shared::Shared()
   if(FAILED(m_device->CreateSamplerState(&samplerDesc, &m_samplerState)))
     throw backend_error { "failed to create sampler state" };
   m_device->PSSetSamplers(0, 1, &m_samplerState.p);
+
+  for(size_t i {}; i < m_formatBuffers.size(); ++i) {
+    const int format[4] { static_cast<int>(i) }; // 16 bytes minimum
+    constexpr D3D10_BUFFER_DESC bufferDesc {
+      .ByteWidth = sizeof(format),
+      .Usage     = D3D10_USAGE_IMMUTABLE,
+      .BindFlags = D3D10_BIND_CONSTANT_BUFFER,
+    };
+    const D3D10_SUBRESOURCE_DATA bufferData { .pSysMem = format };
+    if(FAILED(m_device->CreateBuffer(&bufferDesc, &bufferData,
+                                     &m_formatBuffers[i])))
+      throw backend_error { "failed to create pixel constant buffer" };
+  }
 }
 
 D3D10Renderer::Shared::~Shared()
@@ -209,20 +232,46 @@ void D3D10Renderer::Shared::textureCommand(const TextureCmd &cmd)
   switch(cmd.type) {
   case TextureCmd::Insert:
     m_textures.insert(m_textures.begin() + cmd.offset, cmd.size, nullptr);
+    m_formats.insert(m_formats.begin() + cmd.offset, cmd.size, Texture::RGBA8);
     break;
   case TextureCmd::Update:
-    // calls Release() on the textures in the range to replace
-    std::fill_n(m_textures.begin() + cmd.offset, cmd.size, nullptr);
+    for(size_t i {}; i < cmd.size; ++i) {
+      CComPtr<ID3D10ShaderResourceView> &view { m_textures[cmd.offset + i] };
+      const Texture::Format format { cmd[i].format() };
+      if(Texture::Region region; view &&
+          m_formats[cmd.offset + i] == format && cmd.updateRegion(i, &region)) {
+        // modify the existing texture in place
+        int width, height;
+        const unsigned char *pixels { cmd[i].getPixels(&width, &height) };
+        const int bpp { Texture::bytesPerPixel(format) };
+        CComPtr<ID3D10Resource> resource;
+        view->GetResource(&resource);
+        const D3D10_BOX box {
+          static_cast<UINT>(region.left),  static_cast<UINT>(region.top),   0,
+          static_cast<UINT>(region.right), static_cast<UINT>(region.bottom), 1,
+        };
+        m_device->UpdateSubresource(resource, 0, &box,
+          pixels + ((region.top * width) + region.left) * bpp, width * bpp, 0);
+      }
+      else
+        view = nullptr; // calls Release(), the texture is re-created below
+    }
     break;
   case TextureCmd::Remove:
     m_textures.erase(m_textures.begin() + cmd.offset,
                      m_textures.begin() + cmd.offset + cmd.size);
+    m_formats.erase(m_formats.begin() + cmd.offset,
+                    m_formats.begin() + cmd.offset + cmd.size);
     return;
   }
 
   for(size_t i {}; i < cmd.size; ++i) {
+    if(m_textures[cmd.offset + i])
+      continue; // updated in place
+
     int width, height;
     const unsigned char *pixels { cmd[i].getPixels(&width, &height) };
+    const Texture::Format format { cmd[i].format() };
 
     CComPtr<ID3D10Texture2D> texture;
     const D3D10_TEXTURE2D_DESC textureDesc {
@@ -230,25 +279,26 @@ void D3D10Renderer::Shared::textureCommand(const TextureCmd &cmd)
       .Height = static_cast<unsigned int>(height),
       .MipLevels = 1,
       .ArraySize = 1,
-      .Format = DXGI_FORMAT_R8G8B8A8_UNORM,
+      .Format = dxgiFormat(format),
       .SampleDesc = { .Count = 1 },
       .Usage = D3D10_USAGE_DEFAULT,
       .BindFlags = D3D10_BIND_SHADER_RESOURCE,
     };
     const D3D10_SUBRESOURCE_DATA subResourceDesc {
       .pSysMem = pixels,
-      .SysMemPitch = textureDesc.Width * 4,
+      .SysMemPitch = textureDesc.Width * Texture::bytesPerPixel(format),
     };
     if(FAILED(m_device->CreateTexture2D(&textureDesc, &subResourceDesc, &texture)))
       throw backend_error { "failed to create texture" };
 
     const D3D10_SHADER_RESOURCE_VIEW_DESC resourceViewDesc {
-      .Format = DXGI_FORMAT_R8G8B8A8_UNORM,
+      .Format = textureDesc.Format,
       .ViewDimension = D3D10_SRV_DIMENSION_TEXTURE2D,
       .Texture2D = { .MipLevels = textureDesc.MipLevels },
     };
     m_device->CreateShaderResourceView(texture,
       &resourceViewDesc, &m_textures[cmd.offset + i]);
+    m_formats[cmd.offset + i] = format;
   }
 }
 
@@ -405,6 +455,7 @@ void D3D10Renderer::render(void *)
   const ImVec2 &clipOffset { drawData->DisplayPos },
                &clipScale  { viewport->DpiScale, viewport->DpiScale };
   int globalVtxOffset {}, globalIdxOffset {};
+  std::optional<Texture::Format> format;
   for(int i {}; i < drawData->CmdListsCount; ++i) {
     const ImDrawList *cmdList { drawData->CmdLists[i] };
     for(int j {}; j < cmdList->CmdBuffer.Size; ++j) {
@@ -418,8 +469,15 @@ void D3D10Renderer::render(void *)
         continue;
       device->RSSetScissorRects(1, reinterpret_cast<const D3D10_RECT *>(&clipRect));
 
-      ID3D10ShaderResourceView *texture { m_shared->m_textures[cmd->GetTexID()] };
+      const size_t texID { cmd->GetTexID() };
+      ID3D10ShaderResourceView *texture { m_shared->m_textures[texID] };
       device->PSSetShaderResources(0, 1, &texture);
+      if(const Texture::Format texFormat { m_shared->m_formats[texID] };
+          format != texFormat) {
+        format = texFormat;
+        device->PSSetConstantBuffers(0, 1,
+          &m_shared->m_formatBuffers[texFormat].p);
+      }
       device->DrawIndexed(cmd->ElemCount, cmd->IdxOffset + globalIdxOffset,
                                           cmd->VtxOffset + globalVtxOffset);
     }
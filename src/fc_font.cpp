@@ -17,18 +17,31 @@
 
 #include "font.hpp"
 
+#include <chrono>
 #include <fontconfig/fontconfig.h>
+#include <map>
+#include <optional>
 
+// Loading the configuration and matching against every installed font can take
+// tens of milliseconds. Both are reused until fontconfig reports changes to its
+// configuration files or font directories.
 class FontConfig {
 public:
   FontConfig() : m_fc { FcInitLoadConfigAndFonts() } {}
   FontConfig(const FontConfig &) = delete;
   ~FontConfig() { FcConfigDestroy(m_fc); }
 
-  operator FcConfig *() { return m_fc; }
+  bool resolve(const char *family, int style, Font::Source *);
 
 private:
+  using Clock = std::chrono::steady_clock;
+
+  void bringUpToDate();
+  std::optional<Font::Source> match(const char *family, int style);
+
   FcConfig *m_fc;
+  Clock::time_point m_nextCheck;
+  std::map<std::pair<std::string, int>, std::optional<Font::Source>> m_cache;
 };
 
 class FontPattern {
@@ -100,10 +113,44 @@ FontPattern FontPattern::bestMatch(FcConfig *fc)
   return { FcFontMatch(fc, m_pattern, &result) };
 }
 
-bool Font::resolve(const char *family, const int style)
+void FontConfig::bringUpToDate()
+{
+  // same throttling as FcInitBringUptoDate does for the default configuration
+  const auto now { Clock::now() };
+  if(now < m_nextCheck)
+    return;
+  const int interval { FcConfigGetRescanInterval(m_fc) };
+  m_nextCheck = interval > 0 ? now + std::chrono::seconds { interval }
+                             : Clock::time_point::max();
+
+  if(FcConfigUptoDate(m_fc))
+    return;
+
+  FcConfigDestroy(m_fc);
+  m_fc = FcInitLoadConfigAndFonts();
+  m_cache.clear();
+}
+
+bool FontConfig::resolve(const char *family, const int style,
+  Font::Source *source)
 {
-  FontConfig fc;
+  bringUpToDate();
 
+  const std::pair<std::string, int> key { family, style };
+  auto it { m_cache.find(key) };
+  if(it == m_cache.end())
+    it = m_cache.emplace(key, match(family, style)).first;
+
+  if(!it->second)
+    return false;
+
+  *source = *it->second;
+  return true;
+}
+
+std::optional<Font::Source> FontConfig::match(const char *family,
+  const int style)
+{
   FontPattern query;
   query.add(FC_FAMILY, family);
   query.add(FC_WEIGHT,
@@ -111,20 +158,27 @@ bool Font::resolve(const char *family, const int style)
   query.add(FC_SLANT,
     style & ReaImGuiFontFlags_Italic ? FC_SLANT_ITALIC : FC_SLANT_ROMAN);
 
-  const FontPattern &font { query.bestMatch(fc) };
+  const FontPattern &font { query.bestMatch(m_fc) };
   if(!font)
-    return false;
+    return std::nullopt;
 
-  m_data = font.get<const char *>(FC_FILE);
-  m_index = font.get<int>(FC_INDEX);
+  Font::Source source;
+  source.data  = font.get<const char *>(FC_FILE);
+  source.index = font.get<int>(FC_INDEX);
 
   // FC_WEIGHT is bold if requested in the query even if the chosen font doesn't
   // support that style. FC_EMBOLDEN is true in those cases.
-  m_missingStyles = style;
+  source.missingStyles = style;
   if(font.get<int>(FC_WEIGHT) > FC_WEIGHT_NORMAL && !font.get<bool>(FC_EMBOLDEN))
-    m_missingStyles &= ~ReaImGuiFontFlags_Bold;
+    source.missingStyles &= ~ReaImGuiFontFlags_Bold;
   if(font.get<int>(FC_SLANT) == FC_SLANT_ITALIC)
-    m_missingStyles &= ~ReaImGuiFontFlags_Italic;
+    source.missingStyles &= ~ReaImGuiFontFlags_Italic;
 
-  return true;
+  return source;
+}
+
+bool Font::resolve(const char *family, const int style, Source *source)
+{
+  static FontConfig fc;
+  return fc.resolve(family, style, source);
 }
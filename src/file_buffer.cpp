@@ -0,0 +1,121 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "file_buffer.hpp"
+
+#include "error.hpp"
+#include "win32_unicode.hpp"
+
+#ifdef _WIN32
+#  include <algorithm>
+#  include <cstdint> // SIZE_MAX
+#  include <windows.h>
+#else
+#  include <cerrno>
+#  include <cstring> // strerror
+#  include <fcntl.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#ifdef _WIN32
+static std::string lastError()
+{
+  wchar_t *buffer {};
+  FormatMessageW(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM |
+    FORMAT_MESSAGE_IGNORE_INSERTS, nullptr, GetLastError(), 0,
+    reinterpret_cast<wchar_t *>(&buffer), 0, nullptr);
+  std::string message { buffer ? narrow(buffer) : "unknown error" };
+  LocalFree(buffer);
+  return message;
+}
+
+FileBuffer::FileBuffer(const char *path)
+{
+  const HANDLE file { CreateFileW(WIDEN(path), GENERIC_READ, FILE_SHARE_READ,
+    nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr) };
+  if(file == INVALID_HANDLE_VALUE)
+    throw reascript_error { lastError() };
+
+  LARGE_INTEGER size;
+  if(!GetFileSizeEx(file, &size)) {
+    const std::string error { lastError() };
+    CloseHandle(file);
+    throw reascript_error { error };
+  }
+  else if(static_cast<unsigned long long>(size.QuadPart) > SIZE_MAX) {
+    CloseHandle(file);
+    throw reascript_error { "file is too large" };
+  }
+  m_data.resize(size.QuadPart);
+
+  size_t offset {};
+  while(offset < m_data.size()) {
+    const DWORD chunk { static_cast<DWORD>(
+      std::min<size_t>(m_data.size() - offset, 1 << 30)) };
+    DWORD read;
+    if(!ReadFile(file, m_data.data() + offset, chunk, &read, nullptr)) {
+      const std::string error { lastError() };
+      CloseHandle(file);
+      throw reascript_error { error };
+    }
+    else if(!read)
+      break; // truncated since GetFileSizeEx
+    offset += read;
+  }
+
+  CloseHandle(file);
+  m_data.resize(offset);
+}
+#else
+FileBuffer::FileBuffer(const char *path)
+{
+  const int fd { open(path, O_RDONLY | O_CLOEXEC) };
+  if(fd < 0)
+    throw reascript_error { strerror(errno) };
+
+  struct stat info;
+  if(fstat(fd, &info)) {
+    const int error { errno };
+    close(fd);
+    throw reascript_error { strerror(error) };
+  }
+  else if(!S_ISREG(info.st_mode)) {
+    close(fd);
+    throw reascript_error { "not a regular file" };
+  }
+  m_data.resize(info.st_size);
+
+  size_t offset {};
+  while(offset < m_data.size()) {
+    const ssize_t count { read(fd, m_data.data() + offset, m_data.size() - offset) };
+    if(count < 0 && errno == EINTR)
+      continue;
+    else if(count < 0) {
+      const int error { errno };
+      close(fd);
+      throw reascript_error { strerror(error) };
+    }
+    else if(!count)
+      break; // truncated since fstat
+    offset += count;
+  }
+
+  close(fd);
+  m_data.resize(offset);
+}
+#endif
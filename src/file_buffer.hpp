@@ -0,0 +1,43 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAIMGUI_FILE_BUFFER_HPP
+#define REAIMGUI_FILE_BUFFER_HPP
+
+#include <cstddef>
+#include <vector>
+
+// Contents of a whole file, read up front.
+//
+// The data is copied instead of memory mapped because users hold onto it for
+// a long time (fonts, background decoding): a mapped file that is truncated
+// or on a volume that goes away in the meantime would crash REAPER on the
+// next access (SIGBUS/EXCEPTION_IN_PAGE_ERROR) with no way to recover.
+// Files replaced or modified after being read have no effect on the buffer.
+class FileBuffer {
+public:
+  FileBuffer(const char *path);
+  FileBuffer(const FileBuffer &) = delete;
+
+  const unsigned char *data() const { return m_data.data(); }
+  size_t size() const { return m_data.size(); }
+
+private:
+  std::vector<unsigned char> m_data;
+};
+
+#endif
@@ -17,78 +17,778 @@
 
 #include "font.hpp"
 
+#include "error.hpp"
+#include "file_buffer.hpp"
+#include "glyph_cache.hpp"
 #include "texture.hpp"
+#include "thread_pool.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <map>
 #include <imgui/imgui.h>
 #include <imgui/imgui_internal.h>
 #include <imgui/misc/freetype/imgui_freetype.h>
 
-static const unsigned char *getPixels(void *object, const float scale,
-  int *width, int *height)
+// detached fonts are kept in the atlases for a while in case they are
+// attached again (eg. when previewing fonts)
+constexpr std::chrono::seconds COMPACT_DELAY { 2 };
+// texture size of an atlas page, fonts larger than this get a page of their own
+constexpr size_t PAGE_AREA { 2048 * 2048 };
+// U+0020 to U+00FF, see ImFontAtlas::GetGlyphRangesDefault
+constexpr size_t DEFAULT_FONT_GLYPHS { 0xFF - 0x20 + 1 };
+// of the glyphs rendered as distance fields, regardless of the font's size
+// and of the DPI scale
+constexpr float DISTANCE_FIELD_SIZE { 32.f };
+
+// rough estimate of the texture area used by glyphs of the given pixel size
+static size_t glyphArea(const size_t glyphs, const float size)
 {
-  FontList *list { static_cast<FontList *>(object) };
-  ImFontAtlas *atlas { list->getAtlas(scale) };
-  unsigned char *pixels {};
-  atlas->GetTexDataAsRGBA32(&pixels, width, height);
-  return pixels;
+  // glyphs are about half as wide as they are tall, plus padding
+  const auto height { static_cast<size_t>(size) + 1 };
+  return glyphs * height * ((height / 2) + 1);
 }
 
-static bool removeScale(void *object, const float scale)
+static std::vector<unsigned int> upfrontGlyphs(const ImFontConfig &cfg,
+  ImFontAtlas *atlas)
 {
-  FontList *list { static_cast<FontList *>(object) };
-  return list->removeAtlas(scale);
+  std::vector<unsigned int> codepoints;
+  const ImWchar *ranges
+    { cfg.GlyphRanges ? cfg.GlyphRanges : atlas->GetGlyphRangesDefault() };
+  for(; ranges[0]; ranges += 2) {
+    for(unsigned int c { ranges[0] }; c <= ranges[1]; ++c)
+      codepoints.push_back(c);
+  }
+  return codepoints;
 }
 
-Font::Font(const char *family, const int size, const int flags)
-  : m_size { size }
+// Fonts are often shared by multiple scripts and large (eg. CJK). Their files
+// are read once for as long as a font instance uses them.
+static std::shared_ptr<const FileBuffer> readFile(const std::string &path)
 {
-  const int style { flags & ReaImGuiFontFlags_StyleMask };
-  if(strpbrk(family, "/\\") || !resolve(family, style)) {
-    m_data = family;
-    m_index = flags & ReaImGuiFontFlags_IndexMask;
-    m_missingStyles = style;
+  static std::map<std::string, std::weak_ptr<const FileBuffer>> files;
+
+  if(const auto it { files.find(path) }; it != files.end()) {
+    if(auto file { it->second.lock() })
+      return file;
+    files.erase(it);
   }
+
+  auto file { std::make_shared<const FileBuffer>(path.c_str()) };
+  files.emplace(path, file);
+  return file;
+}
+
+struct Font::GlyphRanges : ImVector<ImWchar> {};
+
+Font::Font(const char *family, const int size, const int flags,
+    const char *glyphs)
+  : m_size { size }, m_bytes {}, m_distanceField { !!(flags & ReaImGuiFontFlags_SDF) }
+{
+  if(m_distanceField && !GlyphRasterizer::supportsDistanceFields())
+    throw reascript_error { "SDF fonts require FreeType 2.11 or newer" };
+
+  const int style { flags & ReaImGuiFontFlags_StyleMask };
+  if(strpbrk(family, "/\\") || !resolve(family, style, &m_source))
+    m_source = { family, flags & ReaImGuiFontFlags_IndexMask, style };
+
+  if(!glyphs)
+    return;
+
+  ImFontGlyphRangesBuilder builder;
+  builder.AddText(glyphs);
+  // used by Dear ImGui for the fallback and tab glyphs
+  builder.AddChar('?');
+  builder.AddChar(' ');
+  auto ranges { std::make_shared<GlyphRanges>() };
+  builder.BuildRanges(ranges.get());
+  m_glyphRanges = std::move(ranges);
+
+  // other characters are rasterized on demand, including ASCII
+  for(ImWchar c { 0x20 }; c < 0x7F; ++c)
+    m_missingASCII[c] = !builder.GetBit(c);
+  if(m_missingASCII.any())
+    GlyphRequests::get().addASCIISubset(m_missingASCII);
+}
+
+Font::~Font()
+{
+  if(m_missingASCII.any())
+    GlyphRequests::get().removeASCIISubset(m_missingASCII);
 }
 
-ImFont *Font::load(ImFontAtlas *atlas, const float scale)
+ImFontConfig Font::config(const float scale) const
 {
   ImFontConfig cfg;
-  // light hinting solves uneven glyph height on macOS
-  cfg.FontBuilderFlags |= ImGuiFreeTypeBuilderFlags_LightHinting |
-                          ImGuiFreeTypeBuilderFlags_LoadColor;
-  if(m_missingStyles & ReaImGuiFontFlags_Bold)
+  // distance fields are scaled, hinting for their size would distort them
+  if(m_distanceField)
+    cfg.FontBuilderFlags |= ImGuiFreeTypeBuilderFlags_NoHinting;
+  else {
+    // light hinting solves uneven glyph height on macOS
+    cfg.FontBuilderFlags |= ImGuiFreeTypeBuilderFlags_LightHinting |
+                            ImGuiFreeTypeBuilderFlags_LoadColor;
+  }
+  if(m_source.missingStyles & ReaImGuiFontFlags_Bold)
     cfg.FontBuilderFlags |= ImGuiFreeTypeBuilderFlags_Bold;
-  if(m_missingStyles & ReaImGuiFontFlags_Italic)
+  if(m_source.missingStyles & ReaImGuiFontFlags_Italic)
     cfg.FontBuilderFlags |= ImGuiFreeTypeBuilderFlags_Oblique;
-  cfg.FontNo = m_index;
+  cfg.FontNo = m_source.index;
+  cfg.SizePixels = m_distanceField ? DISTANCE_FIELD_SIZE :
+                   static_cast<int>(m_size * scale);
+  if(m_glyphRanges)
+    cfg.GlyphRanges = m_glyphRanges->Data;
+  // the atlases read from the bytes of the font instead of copying them
+  cfg.FontData = const_cast<unsigned char *>(m_bytes.data);
+  cfg.FontDataSize = m_bytes.size;
+  cfg.FontDataOwnedByAtlas = false;
+  return cfg;
+}
 
-  const int scaledSize { static_cast<int>(m_size * scale) };
+bool Font::loadBytes()
+{
+  if(m_bytes.owner)
+    return true;
 
-  ImFont *font;
-  if(const std::string *path { std::get_if<std::string>(&m_data) })
-    font = atlas->AddFontFromFileTTF(path->c_str(), scaledSize, &cfg);
+  if(const std::string *path { std::get_if<std::string>(&m_source.data) }) {
+    try {
+      auto file { readFile(*path) };
+      m_bytes.data = file->data();
+      m_bytes.size = file->size();
+      m_bytes.owner = std::move(file);
+    }
+    catch(const reascript_error &) {
+      return false;
+    }
+  }
   else {
-    cfg.FontDataOwnedByAtlas = false;
-    auto &data { std::get<std::vector<unsigned char>>(m_data) };
-    font = atlas->AddFontFromMemoryTTF(data.data(), data.size(), scaledSize, &cfg);
+    const auto &data { std::get<FontData>(m_source.data) };
+    m_bytes.data = data->data();
+    m_bytes.size = data->size();
+    m_bytes.owner = data;
+  }
+
+  m_bytes.hash = ImHashData(m_bytes.data, m_bytes.size);
+  return true;
+}
+
+bool Font::addToKey(FontCache::Key *key, ImFontAtlas *atlas,
+  const float scale)
+{
+  if(!loadBytes())
+    return false;
+
+  const ImFontConfig cfg { config(scale) };
+  key->add(m_bytes.size);
+  key->add(m_bytes.hash);
+  key->add(cfg.FontNo);
+  key->add(cfg.FontBuilderFlags);
+  key->add(cfg.SizePixels);
+  key->add(m_distanceField);
+
+  const ImWchar *ranges
+    { cfg.GlyphRanges ? cfg.GlyphRanges : atlas->GetGlyphRangesDefault() };
+  do
+    key->add(*ranges);
+  while(*ranges++);
+
+  return true;
+}
+
+size_t Font::estimateArea(ImFontAtlas *atlas, const float scale) const
+{
+  const ImFontConfig cfg { config(scale) };
+  const ImWchar *ranges
+    { cfg.GlyphRanges ? cfg.GlyphRanges : atlas->GetGlyphRangesDefault() };
+  size_t glyphs {};
+  for(; ranges[0]; ranges += 2)
+    glyphs += ranges[1] - ranges[0] + 1;
+  if(m_distanceField) {
+    return glyphArea(glyphs,
+      cfg.SizePixels + (GlyphRasterizer::DISTANCE_FIELD_SPREAD * 2));
   }
+  return glyphArea(glyphs, cfg.SizePixels);
+}
 
-  font->Scale = 1.f / scale;
+float Font::instanceScale(const float scale) const
+{
+  // distance fields are the same at every scale
+  return m_distanceField ? m_size / DISTANCE_FIELD_SIZE : 1.f / scale;
+}
+
+auto Font::loader(const float scale) const -> Loader
+{
+  // the font may be destroyed while the atlas is being built
+  return [owner { m_bytes.owner }, ranges { m_glyphRanges },
+          cfg { config(scale) }, distanceField { m_distanceField }](ImFontAtlas *atlas) {
+    if(!owner)
+      throw reascript_error { "cannot read the font file" };
 
-  return font;
+    ImFontConfig fontCfg { cfg };
+    if(distanceField) {
+      // only the metrics, the glyphs are rendered by DynamicGlyphs
+      static constexpr ImWchar space[] { 0x20, 0x20, 0 };
+      fontCfg.GlyphRanges = space;
+    }
+    atlas->AddFontFromMemoryTTF(fontCfg.FontData,
+      fontCfg.FontDataSize, fontCfg.SizePixels, &fontCfg);
+  };
 }
 
-FontList::FontList(TextureManager *manager)
-  : m_textureManager { manager }, m_rebuild { false }
+GlyphRasterizer::Factory Font::rasterizer(const float scale) const
+{
+  return [owner { m_bytes.owner }, cfg { config(scale) },
+          distanceField { m_distanceField }] {
+    try {
+      if(owner)
+        return std::make_unique<GlyphRasterizer>(cfg, owner, distanceField);
+    }
+    catch(const reascript_error &) {}
+
+    return std::unique_ptr<GlyphRasterizer> {};
+  };
+}
+
+// Built once for all contexts using the same fonts at the same scale.
+// Fonts are split across multiple atlases (pages), each with its own texture,
+// instead of growing a single texture up to the size limit of the GPU.
+class SharedAtlas : public std::enable_shared_from_this<SharedAtlas> {
+public:
+  // builds in a worker thread if async, see isReady
+  static std::shared_ptr<SharedAtlas> acquire(const std::vector<Font *> &,
+                                              float scale, bool async);
+
+  SharedAtlas();
+  SharedAtlas(const SharedAtlas &) = delete;
+  ~SharedAtlas();
+
+  // throws if the build failed
+  bool isReady();
+  // the first page has the default font
+  ImFontAtlas *get() const { return page(0); }
+  size_t pages() const { return m_pages.size(); }
+  ImFontAtlas *page(const size_t i) const { return m_pages[i].atlas.get(); }
+  // the default font followed by the fonts given to acquire, in any page
+  const std::vector<ImFont *> &fonts() const { return m_fonts; }
+  // of all pages
+  unsigned int generation() const { return m_generation; }
+  unsigned int generation(const size_t page) const
+    { return m_pages[page].generation; }
+  bool changes(const size_t page, const unsigned int since,
+               Texture::Region *region) const
+    { return m_pages[page].history.since(since, region); }
+  Texture::Format format(const size_t page) const
+    { return m_pages[page].glyphs->format(); }
+  // must be replaced by a new build to free space
+  bool isStale() const { return m_stale; }
+  // in seconds, or to load it from the cache
+  double buildTime() const { return m_buildTime; }
+
+  void addUser(const FontList *);
+  void removeUser(const FontList *);
+  void addRequestedGlyphs();
+  // adds the last font in the list without rebuilding, false if not possible
+  bool append(const std::vector<Font *> &, float scale);
+
+private:
+  struct Job;
+
+  struct Page {
+    std::unique_ptr<ImFontAtlas> atlas;
+    std::unique_ptr<DynamicGlyphs> glyphs;
+    ChangeHistory history;
+    unsigned int generation;
+  };
+
+  using Registry = std::map<std::vector<unsigned char>,
+                            std::weak_ptr<SharedAtlas>>;
+  static Registry &registry();
+  // distance fields are the same at every size, only ImFont::Scale differs
+  static bool makeKey(const std::vector<Font *> &, float scale,
+                      ImFontAtlas *, FontCache::Key *, bool withSizes = true);
+
+  bool failed() const;
+  void unregister();
+  void addChange(Page &, int oldHeight, Texture::Format oldFormat,
+                 const Texture::Region &);
+
+  std::vector<Page> m_pages;
+  std::vector<ImFont *> m_fonts;
+  std::shared_ptr<Job> m_job;
+  std::vector<const FontList *> m_users;
+  std::vector<unsigned char> m_key; // empty if not shareable
+  unsigned int m_generation;
+  size_t m_requestsSeen;
+  double m_buildTime;
+  bool m_stale;
+};
+
+// Everything needed to build the atlas without accessing the fonts, which
+// may be destroyed before a worker is done.
+struct SharedAtlas::Job {
+  enum State { Pending, Done, Failed };
+
+  struct Page {
+    Page(const float scale)
+      : key { scale }, atlas { std::make_unique<ImFontAtlas>() },
+        distanceField { false } {}
+
+    FontCache::Key key;
+    std::vector<Font::Loader> loaders;
+    std::vector<GlyphRasterizer::Factory> rasterizers;
+    std::vector<size_t> indices; // of the fonts in Job::fonts
+    std::vector<float> instanceScales; // not in the key of distance fields
+    // glyphs to render as distance fields after building, for each font
+    std::vector<std::vector<unsigned int>> upfrontGlyphs;
+    std::unique_ptr<ImFontAtlas> atlas;
+    std::unique_ptr<DynamicGlyphs> glyphs;
+    bool distanceField;
+  };
+
+  Job(const FontCache::Key &key) : key { key } {}
+  void run();
+  void build(Page &, bool withDefaultFont);
+
+  FontCache::Key key;
+  const FontCache *cache; // null if not cacheable
+  float scale;
+  std::vector<Page> pages;
+  std::vector<unsigned int> recentGlyphs;
+
+  std::vector<ImFont *> fonts;
+  std::string error;
+  std::chrono::duration<double> buildTime;
+  std::atomic<State> state { Pending };
+};
+
+void SharedAtlas::Job::run()
+try {
+  const auto start { std::chrono::steady_clock::now() };
+
+  for(size_t i {}; i < pages.size(); ++i)
+    build(pages[i], i == 0);
+
+  buildTime = std::chrono::steady_clock::now() - start;
+  state = Done;
+}
+catch(const std::exception &e) {
+  error = e.what();
+  state = Failed;
+}
+
+void SharedAtlas::Job::build(Page &page, const bool withDefaultFont)
+{
+  ImFontAtlas *atlas { page.atlas.get() };
+
+  // rasterizing large fonts (eg. CJK) at every launch is slow
+  const bool cached { cache && cache->load(atlas, page.key) };
+  if(!cached) {
+    atlas->ClearFonts();
+
+    if(withDefaultFont) {
+      ImFontConfig cfg;
+      cfg.SizePixels = 13.f * scale;
+      ImFont *defFont { atlas->AddFontDefault(&cfg) };
+      defFont->Scale = 1.f / scale;
+    }
+
+    for(const Font::Loader &loader : page.loaders)
+      loader(atlas);
+
+    atlas->Flags |= ImFontAtlasFlags_NoMouseCursors;
+    atlas->Build();
+    atlas->ClearInputData();
+    page.loaders.clear(); // release the font data, not owned by the atlas
+  }
+
+  if(withDefaultFont)
+    fonts[0] = atlas->Fonts[0];
+
+  // characters outside of the built ranges are rasterized on demand
+  page.glyphs = std::make_unique<DynamicGlyphs>(atlas, page.distanceField);
+  const int first { withDefaultFont ? 1 : 0 };
+  for(size_t i {}; i < page.rasterizers.size(); ++i) {
+    ImFont *instance { atlas->Fonts[first + i] };
+    instance->Scale = page.instanceScales[i]; // cached for another size
+    page.glyphs->addFont(instance, std::move(page.rasterizers[i]));
+    fonts[page.indices[i]] = instance;
+  }
+
+  Texture::Region region {}; // the whole texture is uploaded after a build
+  if(!cached) {
+    for(size_t i {}; i < page.upfrontGlyphs.size(); ++i) {
+      ImFont *instance { atlas->Fonts[first + i] };
+      // was the space character, the only glyph built by ImFontAtlas
+      instance->FallbackChar = static_cast<ImWchar>(-1);
+      page.glyphs->add(page.upfrontGlyphs[i], 0, true, &region, instance);
+    }
+    page.upfrontGlyphs.clear();
+
+    if(cache)
+      cache->save(atlas, page.key);
+  }
+  page.glyphs->add(recentGlyphs, 0, true, &region);
+}
+
+auto SharedAtlas::registry() -> Registry &
+{
+  static Registry instance;
+  return instance;
+}
+
+bool SharedAtlas::makeKey(const std::vector<Font *> &fonts, const float scale,
+  ImFontAtlas *atlas, FontCache::Key *key, const bool withSizes)
+{
+  *key = FontCache::Key { scale };
+  key->add(ImFontAtlasFlags_NoMouseCursors);
+
+  for(Font *font : fonts) {
+    if(!font->addToKey(key, atlas, scale))
+      return false;
+    if(withSizes && font->distanceField())
+      key->add(font->instanceScale(scale));
+  }
+
+  return true;
+}
+
+std::shared_ptr<SharedAtlas> SharedAtlas::acquire(
+  const std::vector<Font *> &fonts, const float scale, const bool async)
+{
+  auto job { std::make_shared<Job>(FontCache::Key { scale }) };
+  job->pages.emplace_back(scale);
+  ImFontAtlas *firstAtlas { job->pages.front().atlas.get() };
+
+  const bool cacheable
+    { makeKey(fonts, scale, firstAtlas, &job->key) };
+
+  if(cacheable) {
+    const auto it { registry().find(job->key.data()) };
+    auto existing { it != registry().end() ? it->second.lock() : nullptr };
+    // don't wait for another context's background build
+    if(existing && !existing->m_stale && !existing->failed() &&
+        (async || existing->isReady()))
+      return existing;
+  }
+
+  AtlasPages layout { PAGE_AREA, glyphArea(DEFAULT_FONT_GLYPHS, 13.f * scale) };
+  for(size_t i {}; i < fonts.size(); ++i) {
+    Font *font { fonts[i] };
+    layout.add(i, font->distanceField(), font->estimateArea(firstAtlas, scale));
+  }
+
+  job->cache = cacheable ? &FontCache::get() : nullptr;
+  job->scale = scale;
+  job->fonts.resize(fonts.size() + 1);
+  for(size_t i {}; i < layout.pages().size(); ++i) {
+    if(i > 0)
+      job->pages.emplace_back(scale);
+    Job::Page &page { job->pages.back() };
+    const AtlasPages::Page &source { layout.pages()[i] };
+    std::vector<Font *> pageFonts;
+    for(const size_t index : source.fonts) {
+      pageFonts.push_back(fonts[index]);
+      page.indices.push_back(index + 1); // after the default font
+    }
+    page.distanceField = source.distanceField;
+    if(source.distanceField) {
+      page.atlas->TexDesiredWidth = AtlasPages::distanceFieldWidth(source.area);
+      // lines would be sampled as distances
+      page.atlas->Flags |= ImFontAtlasFlags_NoBakedLines;
+    }
+    if(cacheable && source.distanceField) {
+      // the same at every scale and size
+      makeKey(pageFonts, 1.f, page.atlas.get(), &page.key, false);
+      page.key.add(ImFontAtlasFlags_NoBakedLines);
+    }
+    else if(cacheable) {
+      makeKey(pageFonts, scale, page.atlas.get(), &page.key);
+      if(i > 0)
+        page.key.add(i); // without the default font
+    }
+    for(Font *font : pageFonts) {
+      page.loaders.push_back(font->loader(scale));
+      page.instanceScales.push_back(font->instanceScale(scale));
+      page.rasterizers.push_back(font->rasterizer(scale));
+      if(source.distanceField) {
+        page.upfrontGlyphs.push_back
+          (upfrontGlyphs(font->config(scale), page.atlas.get()));
+      }
+    }
+  }
+  job->recentGlyphs = GlyphRequests::get().recent();
+
+  auto shared { std::make_shared<SharedAtlas>() };
+  shared->m_job = job;
+  shared->m_requestsSeen = GlyphRequests::get().list().size();
+
+  if(cacheable) {
+    shared->m_key = job->key.data();
+    registry()[shared->m_key] = shared;
+  }
+
+  if(async) {
+    ThreadPool::get().push([weakJob = std::weak_ptr<Job> { job }] {
+      if(const auto job { weakJob.lock() })
+        job->run();
+    });
+  }
+  else {
+    job->run();
+    shared->isReady();
+  }
+
+  return shared;
+}
+
+SharedAtlas::SharedAtlas()
+  : m_generation {}, m_requestsSeen {}, m_buildTime {}, m_stale { false }
+{
+}
+
+SharedAtlas::~SharedAtlas()
+{
+  // EndFrame unlocks only the current atlas in io.Fonts
+  for(Page &page : m_pages)
+    page.atlas->Locked = false;
+
+  if(m_key.empty())
+    return;
+  const auto it { registry().find(m_key) };
+  if(it != registry().end() && it->second.expired())
+    registry().erase(it);
+}
+
+bool SharedAtlas::failed() const
+{
+  return m_job && m_job->state == Job::Failed;
+}
+
+void SharedAtlas::unregister()
+{
+  if(m_key.empty())
+    return;
+
+  const auto it { registry().find(m_key) };
+  if(it != registry().end() && it->second.lock().get() == this)
+    registry().erase(it);
+  m_key.clear();
+}
+
+bool SharedAtlas::isReady()
+{
+  if(!m_job)
+    return true;
+
+  switch(m_job->state) {
+  case Job::Pending:
+    return false;
+  case Job::Failed:
+    unregister();
+    throw imgui_error { m_job->error };
+  case Job::Done:
+    break;
+  }
+
+  for(Job::Page &page : m_job->pages) {
+    m_pages.push_back
+      ({ std::move(page.atlas), std::move(page.glyphs), {}, 0 });
+  }
+  m_fonts     = std::move(m_job->fonts);
+  m_buildTime = m_job->buildTime.count();
+  m_job.reset();
+  return true;
+}
+
+void SharedAtlas::addUser(const FontList *user)
+{
+  m_users.push_back(user);
+}
+
+void SharedAtlas::removeUser(const FontList *user)
+{
+  const auto it { std::find(m_users.begin(), m_users.end(), user) };
+  if(it != m_users.end())
+    m_users.erase(it);
+}
+
+void SharedAtlas::addChange(Page &page, const int oldHeight,
+  const Texture::Format oldFormat, const Texture::Region &region)
+{
+  if(region.empty())
+    return;
+
+  ++m_generation;
+  ++page.generation;
+  if(page.atlas->TexHeight != oldHeight || page.glyphs->format() != oldFormat)
+    page.history = {}; // all users must upload the whole texture again
+  else
+    page.history.add(page.generation, region);
+}
+
+void SharedAtlas::addRequestedGlyphs()
+{
+  const auto &requests { GlyphRequests::get().list() };
+  if(m_stale || m_requestsSeen == requests.size())
+    return;
+
+  // growing the texture moves the glyphs used in frames in progress
+  const bool canGrow { std::none_of(m_users.begin(), m_users.end(),
+    [](const FontList *user) { return user->withinFrame(); }) };
+
+  bool postponed {}, evict {};
+  for(Page &page : m_pages) {
+    const int height { page.atlas->TexHeight };
+    const Texture::Format format { page.glyphs->format() };
+    Texture::Region region {};
+    const auto status
+      { page.glyphs->add(requests, m_requestsSeen, canGrow, &region) };
+    addChange(page, height, format, region);
+
+    switch(status) {
+    case DynamicGlyphs::Done:
+      break;
+    case DynamicGlyphs::Postponed:
+      postponed = true; // retry when no frame using this atlas is in progress
+      break;
+    case DynamicGlyphs::Full:
+      // drop the glyphs that were not used recently
+      evict = evict || page.glyphs->evictable();
+      break;
+    }
+  }
+
+  if(evict) {
+    m_stale = true;
+    unregister();
+  }
+  if(!postponed || evict)
+    m_requestsSeen = requests.size();
+}
+
+bool SharedAtlas::append(const std::vector<Font *> &fonts, const float scale)
+{
+  // other contexts keep using the fonts they attached
+  if(m_users.size() > 1 || m_stale || m_job)
+    return false;
+
+  // a new page is started by rebuilding
+  Page &page { m_pages.back() };
+  const size_t area
+    { static_cast<size_t>(page.atlas->TexWidth) * page.atlas->TexHeight };
+  Font *font { fonts.back() };
+  if(font->distanceField() != (page.glyphs->format() == Texture::Distance8) ||
+      area + font->estimateArea(page.atlas.get(), scale) > PAGE_AREA)
+    return false;
+
+  FontCache::Key key { scale };
+  if(!makeKey(fonts, scale, page.atlas.get(), &key))
+    return false; // let a full build report the error
+
+  // no longer matches the previous key (or the one of the disk cache)
+  unregister();
+
+  const ImFontConfig cfg { font->config(scale) };
+  ImFont *instance { page.glyphs->createFont(font->rasterizer(scale),
+                                             cfg.SizePixels) };
+  if(!instance) {
+    m_stale = true;
+    return false;
+  }
+  instance->Scale = font->instanceScale(scale);
+
+  std::vector<unsigned int> codepoints
+    { upfrontGlyphs(cfg, page.atlas.get()) };
+  const auto &recent { GlyphRequests::get().recent() };
+  codepoints.insert(codepoints.end(), recent.begin(), recent.end());
+
+  const int height { page.atlas->TexHeight };
+  const Texture::Format format { page.glyphs->format() };
+  Texture::Region region {};
+  if(page.glyphs->add(codepoints, 0, true, &region, instance) !=
+      DynamicGlyphs::Done) {
+    m_stale = true; // the partially added font must not be used
+    return false;
+  }
+  addChange(page, height, format, region);
+  m_fonts.push_back(instance);
+
+  auto &registered { registry()[key.data()] };
+  if(!registered.lock()) {
+    m_key = key.data();
+    registered = weak_from_this();
+  }
+
+  return true;
+}
+
+auto FontList::page(const float scale, const size_t index) -> Page *
+{
+  const auto it { m_pages.try_emplace({ scale, index },
+                                      Page { this, scale, index }).first };
+  return &it->second;
+}
+
+const SharedAtlas *FontList::Page::shared() const
+{
+  const auto it { list->m_atlases.find(scale) };
+  if(it == list->m_atlases.end() || !it->second.shared ||
+      index >= it->second.shared->pages())
+    return nullptr;
+  return it->second.shared.get();
+}
+
+const unsigned char *FontList::getPixels(void *object, float,
+  int *width, int *height)
+{
+  const Page *page { static_cast<Page *>(object) };
+  ImFontAtlas *atlas { page->shared()->page(page->index) };
+  *width  = atlas->TexWidth;
+  *height = atlas->TexHeight;
+  if(atlas->TexPixelsRGBA32)
+    return reinterpret_cast<const unsigned char *>(atlas->TexPixelsRGBA32);
+  return atlas->TexPixelsAlpha8; // see DynamicGlyphs::format
+}
+
+Texture::Format FontList::format(void *object, float)
+{
+  const Page *page { static_cast<Page *>(object) };
+  const SharedAtlas *shared { page->shared() };
+  return shared ? shared->format(page->index) : Texture::RGBA8;
+}
+
+bool FontList::changes(void *object, float,
+  const unsigned int since, Texture::Region *region)
+{
+  const Page *page { static_cast<Page *>(object) };
+  const SharedAtlas *shared { page->shared() };
+  return shared && shared->changes(page->index, since, region);
+}
+
+bool FontList::isPageValid(void *object)
+{
+  return !!static_cast<Page *>(object)->shared();
+}
+
+bool FontList::removeScale(void *object, const float scale)
+{
+  const Page *page { static_cast<Page *>(object) };
+  // the other pages are removed along with the atlas (see isPageValid)
+  return page->index > 0 || page->list->removeAtlas(scale);
+}
+
+FontList::FontList(ImGuiContext *imgui, TextureManager *manager)
+  : m_imgui { imgui }, m_textureManager { manager }, m_scale {}, m_replacements {},
+    m_compactAt { std::chrono::steady_clock::time_point::max() },
+    m_rebuild { false }, m_rebuilding { false }
 {
 }
 
 FontList::~FontList()
 {
-  for(auto &pair : m_atlases)
-    pair.second->Locked = false;
+  for(auto &[scale, instance] : m_atlases)
+    instance.shared->removeUser(this);
 }
 
 void FontList::invalidate()
@@ -102,9 +802,33 @@ void FontList::add(Font *font)
     return;
 
   m_fonts.push_back(font);
+
+  const bool isActive { std::find(m_activeFonts.begin(), m_activeFonts.end(),
+                                  font) != m_activeFonts.end() };
+  if((isActive && !m_rebuild && !m_rebuilding) || append(font))
+    return;
+
   invalidate();
 }
 
+bool FontList::append(Font *font)
+{
+  if(m_atlases.empty() || m_rebuild || m_rebuilding)
+    return false;
+
+  std::vector<Font *> fonts { m_activeFonts };
+  fonts.push_back(font);
+
+  // atlases that got the font before a failure are replaced by the rebuild
+  for(auto &[scale, instance] : m_atlases) {
+    if(!instance.shared->append(fonts, scale))
+      return false;
+  }
+
+  m_activeFonts = std::move(fonts);
+  return true;
+}
+
 void FontList::remove(Font *font)
 {
   const auto it { std::find(m_fonts.begin(), m_fonts.end(), font) };
@@ -112,22 +836,133 @@ void FontList::remove(Font *font)
     return;
 
   m_fonts.erase(it);
-  invalidate();
+  if(!m_atlases.empty())
+    m_compactAt = std::chrono::steady_clock::now() + COMPACT_DELAY;
+}
+
+bool FontList::withinFrame() const
+{
+  return m_imgui->WithinFrameScope;
+}
+
+void FontList::stats(size_t *bytes, double *buildTime) const
+{
+  *bytes = 0;
+  *buildTime = 0;
+
+  for(const auto &[scale, instance] : m_atlases) {
+    for(size_t i {}; i < instance.shared->pages(); ++i) {
+      const ImFontAtlas *atlas { instance.shared->page(i) };
+      *bytes += atlas->TexWidth * atlas->TexHeight *
+                Texture::bytesPerPixel(instance.shared->format(i));
+    }
+    *buildTime += instance.shared->buildTime();
+  }
+}
+
+uint64_t FontList::version() const
+{
+  // ImFont pointers stay valid until their atlas is replaced or removed
+  unsigned int generations {};
+  for(const auto &[scale, instance] : m_atlases)
+    generations += instance.shared->generation();
+  return (static_cast<uint64_t>(m_replacements) << 32) | generations;
 }
 
 void FontList::update()
 {
-  if(m_atlases.empty())
+  if(m_atlases.empty()) {
+    // the first frame cannot begin without an atlas
+    m_activeFonts = m_fonts;
     setScale(ImGui::GetPlatformIO().Monitors[0].DpiScale);
+  }
 
-  if(m_rebuild) {
-    for(const auto &pair : m_atlases) {
-      // EndFrame unlocks only the current atlas in io.Fonts
-      pair.second->Locked = false;
-      build(pair.first);
-    }
-    m_textureManager->invalidate(this);
+  if(std::chrono::steady_clock::now() >= m_compactAt) {
+    m_compactAt = std::chrono::steady_clock::time_point::max();
+    m_rebuild = m_rebuild || std::any_of(
+      m_activeFonts.begin(), m_activeFonts.end(), [this](Font *font) {
+        return std::find(m_fonts.begin(), m_fonts.end(), font) == m_fonts.end();
+      });
+  }
+
+  // detached fonts must outlive the atlases using them
+  for(Font *font : m_activeFonts)
+    font->keepAlive();
+  for(Font *font : m_pendingFonts)
+    font->keepAlive();
+
+  bool stale { false };
+  for(auto &[scale, instance] : m_atlases) {
+    instance.shared->addRequestedGlyphs();
+    stale = stale || instance.shared->isStale();
+  }
+
+  // the current atlases are used until the new ones are ready
+  if(m_rebuild || (stale && !m_rebuilding)) {
+    m_pendingFonts = m_fonts;
+    for(auto &[scale, instance] : m_atlases)
+      instance.pending = SharedAtlas::acquire(m_pendingFonts, scale, true);
     m_rebuild = false;
+    m_rebuilding = true;
+  }
+
+  if(m_rebuilding) {
+    try {
+      swapAtlases();
+    }
+    catch(const imgui_error &) {
+      // keep the previous fonts instead of retrying every frame
+      for(auto &[scale, instance] : m_atlases)
+        instance.pending.reset();
+      m_fonts.erase(std::remove_if(m_fonts.begin(), m_fonts.end(),
+        [this](Font *font) {
+          return std::find(m_activeFonts.begin(), m_activeFonts.end(), font)
+            == m_activeFonts.end();
+        }), m_fonts.end());
+      m_pendingFonts.clear();
+      m_rebuilding = false;
+      throw;
+    }
+  }
+
+  // upload the glyphs added by any context sharing the atlas
+  const auto current { m_atlases.find(m_scale) };
+  if(current != m_atlases.end())
+    touch(m_scale, current->second);
+}
+
+void FontList::swapAtlases()
+{
+  for(auto &[scale, instance] : m_atlases) {
+    if(!instance.pending) // scale added after the rebuild started
+      instance.pending = SharedAtlas::acquire(m_pendingFonts, scale, true);
+    if(!instance.pending->isReady())
+      return;
+  }
+
+  // all at once, the fonts have the same indices in every atlas
+  const std::shared_ptr<SharedAtlas> from { m_atlases.at(m_scale).shared };
+  std::vector<std::shared_ptr<SharedAtlas>> previous;
+  for(auto &[scale, instance] : m_atlases) {
+    instance.shared->removeUser(this);
+    previous.push_back(std::move(instance.shared));
+    instance.shared = std::move(instance.pending);
+    instance.shared->addUser(this);
+  }
+  m_activeFonts = std::move(m_pendingFonts);
+  m_rebuilding = false;
+
+  // while the previous atlas is still alive
+  ImGui::GetIO().Fonts = getAtlas(m_scale);
+  ++m_replacements;
+  migrateActiveFonts(from.get());
+
+  // the new atlases may have less pages
+  for(auto &[key, page] : m_pages) {
+    if(page.shared())
+      m_textureManager->invalidate(&page);
+    else
+      m_textureManager->remove(&page);
   }
 }
 
@@ -135,30 +970,67 @@ void FontList::setScale(const float scale)
 {
   ImGuiIO &io { ImGui::GetIO() };
 
-  std::unique_ptr<ImFontAtlas> &atlas { m_atlases[scale] };
-  if(!atlas)
-    atlas.reset(new ImFontAtlas);
+  const auto previous { m_atlases.find(m_scale) };
+  const std::shared_ptr<SharedAtlas> from
+    { previous != m_atlases.end() ? previous->second.shared : nullptr };
 
-  const bool atlasChanged { atlas.get() != io.Fonts };
-  io.Fonts = atlas.get();
+  auto it { m_atlases.find(scale) };
+  if(it == m_atlases.end()) {
+    // throws if the fonts cannot be built, without leaving an empty instance
+    auto shared { SharedAtlas::acquire(m_activeFonts, scale, false) };
+    shared->addUser(this);
+    it = m_atlases.emplace(scale, Instance { std::move(shared) }).first;
+  }
 
-  if(!atlas->IsBuilt())
-    build(scale);
+  Instance &instance { it->second };
+
+  ImFontAtlas *atlas { instance.shared->get() };
+  const bool atlasChanged { atlas != io.Fonts };
+  io.Fonts = atlas;
+  m_scale = scale;
 
   if(atlasChanged)
-    migrateActiveFonts();
+    migrateActiveFonts(from.get());
+
+  touch(scale, instance);
+}
+
+void FontList::bindTexture() const
+{
+  const auto it { m_atlases.find(m_scale) };
+  if(it == m_atlases.end())
+    return;
 
-  // after build() because it clears the texture ID!
-  // (via ImFontAtlasBuildWithFreeTypeEx)
-  Texture tex { this, scale, &getPixels };
-  tex.m_compact = &removeScale;
-  atlas->SetTexID(m_textureManager->touch(tex));
+  const Instance &instance { it->second };
+  for(size_t i {}; i < instance.textures.size(); ++i)
+    instance.shared->page(i)->SetTexID(instance.textures[i]);
+}
+
+void FontList::touch(const float scale, Instance &instance)
+{
+  const size_t pages { instance.shared->pages() };
+  instance.textures.resize(pages);
+
+  // inserting the texture of a page may move the ones touched before it
+  for(int pass {}; pass < 2; ++pass) {
+    for(size_t i {}; i < pages; ++i) {
+      Texture tex { page(scale, i), scale, &getPixels };
+      tex.generation = instance.shared->generation(i);
+      tex.m_format  = &format;
+      tex.m_changes = &changes;
+      tex.m_isValid = &isPageValid;
+      tex.m_compact = &removeScale;
+      instance.textures[i] = m_textureManager->touch(tex);
+    }
+  }
+
+  bindTexture();
 }
 
 ImFontAtlas *FontList::getAtlas(const float scale)
 {
   const auto it { m_atlases.find(scale) };
-  return it != m_atlases.end() ? it->second.get() : nullptr;
+  return it != m_atlases.end() ? it->second.shared->get() : nullptr;
 }
 
 bool FontList::removeAtlas(const float scale)
@@ -172,50 +1044,48 @@ bool FontList::removeAtlas(const float scale)
     return true; // let the texture manager free it
 
   ImGuiIO &io { ImGui::GetIO() };
-  if(io.Fonts == it->second.get())
-    io.Fonts = m_atlases[primaryScale].get();
+  if(io.Fonts == it->second.shared->get()) {
+    io.Fonts = getAtlas(primaryScale);
+    m_scale = primaryScale;
+  }
 
-  it->second->Locked = false;
+  it->second.shared->removeUser(this);
   m_atlases.erase(it);
+  ++m_replacements; // the addresses of its fonts may be reused
   return true;
 }
 
-void FontList::build(const float scale)
-{
-  auto &atlas { m_atlases.at(scale) }; // don't insert
-  atlas->ClearFonts();
-
-  ImFontConfig cfg;
-  cfg.SizePixels = 13.f * scale;
-  ImFont *defFont { atlas->AddFontDefault(&cfg) };
-  defFont->Scale = 1.f / scale;
-
-  for(Font *font : m_fonts)
-    font->load(atlas.get(), scale);
-
-  atlas->Flags |= ImFontAtlasFlags_NoMouseCursors;
-  atlas->Build();
-  atlas->ClearInputData();
-}
-
-void FontList::migrateActiveFonts()
+void FontList::migrateActiveFonts(const SharedAtlas *from)
 {
   if(ImFont *currentFont { ImGui::GetFont() })
-    ImGui::SetCurrentFont(toCurrentAtlas(currentFont));
+    ImGui::SetCurrentFont(toCurrentAtlas(currentFont, from));
 
   auto &fontStack { ImGui::GetCurrentContext()->FontStack };
   for(int i {}; i < fontStack.Size; ++i)
-    fontStack[i] = toCurrentAtlas(fontStack[i]);
+    fontStack[i] = toCurrentAtlas(fontStack[i], from);
+}
+
+const SharedAtlas *FontList::current() const
+{
+  const auto it { m_atlases.find(m_scale) };
+  return it != m_atlases.end() ? it->second.shared.get() : nullptr;
 }
 
 Font *FontList::get(ImFont *instance) const
 {
-  const ImFontAtlas *atlas { ImGui::GetIO().Fonts };
-  for(int i { 1 }; i < atlas->Fonts.Size; ++i) {
-    assert(static_cast<size_t>(i) <= m_fonts.size());
+  // the atlas may have more fonts if appending one to every scale failed
+  const auto &instances { current()->fonts() };
+  const size_t size
+    { std::min(instances.size(), m_activeFonts.size() + 1) };
+  for(size_t i { 1 }; i < size; ++i) {
+    if(instances[i] != instance)
+      continue;
 
-    if(atlas->Fonts[i] == instance)
-      return m_fonts[i - 1];
+    // may have been detached while the new atlas is being built
+    Font *font { m_activeFonts[i - 1] };
+    if(std::find(m_fonts.begin(), m_fonts.end(), font) != m_fonts.end())
+      return font;
+    break;
   }
   return nullptr; // default font
 }
@@ -225,28 +1095,34 @@ ImFont *FontList::instanceOf(Font *font) const
   if(!font)
     return nullptr; // default font
 
-  const auto it { std::find(m_fonts.begin(), m_fonts.end(), font) };
-  if(it == m_fonts.end())
+  if(std::find(m_fonts.begin(), m_fonts.end(), font) == m_fonts.end())
     throw reascript_error { "font is not attached to the context" };
 
-  const auto index { std::distance(m_fonts.begin(), it) + 1 };
-  const ImFontAtlas *atlas { ImGui::GetIO().Fonts };
-  assert(index < atlas->Fonts.Size);
-  return atlas->Fonts[index];
+  const auto it
+    { std::find(m_activeFonts.begin(), m_activeFonts.end(), font) };
+  if(it == m_activeFonts.end())
+    return nullptr; // use the default font until the atlas is rebuilt
+
+  const auto index { std::distance(m_activeFonts.begin(), it) + 1 };
+  const auto &instances { current()->fonts() };
+  assert(static_cast<size_t>(index) < instances.size());
+  return instances[index];
 }
 
-ImFont *FontList::toCurrentAtlas(ImFont *oldInstance) const
+ImFont *FontList::toCurrentAtlas(ImFont *oldInstance,
+  const SharedAtlas *from) const
 {
-  const ImFontAtlas *newAtlas { ImGui::GetIO().Fonts },
-                    *oldAtlas { oldInstance->ContainerAtlas };
-
-  if(newAtlas == oldAtlas)
+  const SharedAtlas *to { current() };
+  if(from == to)
     return oldInstance;
 
-  const int size { std::min(oldAtlas->Fonts.Size, newAtlas->Fonts.Size) };
-  for(int i { 0 }; i < size; ++i) {
-    if(oldAtlas->Fonts[i] == oldInstance)
-      return newAtlas->Fonts[i];
+  if(from) {
+    const auto &oldFonts { from->fonts() }, &newFonts { to->fonts() };
+    const size_t size { std::min(oldFonts.size(), newFonts.size()) };
+    for(size_t i {}; i < size; ++i) {
+      if(oldFonts[i] == oldInstance)
+        return newFonts[i];
+    }
   }
 
   return ImGui::GetDefaultFont();
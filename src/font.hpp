@@ -18,14 +18,20 @@
 #ifndef REAIMGUI_FONT_HPP
 #define REAIMGUI_FONT_HPP
 
+#include <chrono>
+#include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "font_cache.hpp"
+#include "glyph_cache.hpp"
 #include "resource.hpp"
 #include "variant.hpp"
 
+class SharedAtlas;
 class TextureManager;
 
 enum FontFlags {
@@ -33,13 +39,17 @@ enum FontFlags {
   ReaImGuiFontFlags_IndexMask = 0xFF, // font index when loading from a collection file
   ReaImGuiFontFlags_Bold      = 1<<8,
   ReaImGuiFontFlags_Italic    = 1<<9,
-  ReaImGuiFontFlags_StyleMask = ~0xFF,
+  ReaImGuiFontFlags_StyleMask = ReaImGuiFontFlags_Bold | ReaImGuiFontFlags_Italic,
+  ReaImGuiFontFlags_SDF       = 1<<10,
 };
 
 struct ImFont;
 struct ImFontAtlas;
+struct ImFontConfig;
+struct ImGuiContext;
 
-class Font final : public Resource {
+class Font final
+  : public TypedResource<Font, Resource, ResourceSubclass_Font> {
 public:
   static constexpr const char *api_type_name { "ImGui_Font" };
 
@@ -51,44 +61,129 @@ public:
     *SANS_SERIF { "sans-serif" },
     *SERIF      { "serif" };
 
-  Font(const char *family, int size, int style);
-  ImFont *load(ImFontAtlas *, float scale);
+  // file path or contents, shared with the atlases using the font
+  using FontData = std::shared_ptr<const std::vector<unsigned char>>;
+  struct Source {
+    std::variant<std::string, FontData> data;
+    int index, missingStyles;
+  };
+
+  // finds the installed font best matching the family name and style
+  static bool resolve(const char *family, int style, Source *);
+
+  // adds the font to an atlas, remains usable after the font is gone
+  using Loader = std::function<void (ImFontAtlas *)>;
+
+  // builds only the given characters upfront if glyphs is not null
+  Font(const char *family, int size, int style, const char *glyphs = nullptr);
+  ~Font();
+  // false if the font data cannot be read, must be called before loader()
+  bool addToKey(FontCache::Key *, ImFontAtlas *, float scale);
+  Loader loader(float scale) const;
+  ImFontConfig config(float scale) const;
+  // rough texture area in pixels of the glyphs built upfront
+  size_t estimateArea(ImFontAtlas *, float scale) const;
+  // ImFont::Scale of the instances built for the given scale
+  float instanceScale(float scale) const;
+  // for rendering glyphs on demand, remains usable after the font is gone
+  GlyphRasterizer::Factory rasterizer(float scale) const;
+  // rasterized once at a reference size and scaled by the renderer
+  bool distanceField() const { return m_distanceField; }
 
   bool attachable(const Context *) const override { return true; }
 
 private:
-  bool resolve(const char *family, int style);
-
-  std::variant<std::string, std::vector<unsigned char>> m_data;
-  int m_index, m_size, m_missingStyles;
+  struct GlyphRanges;
+
+  // the font file (read once per process) or the contents from Source::data
+  struct Bytes {
+    std::shared_ptr<const void> owner;
+    const unsigned char *data;
+    size_t size;
+    unsigned int hash;
+  };
+
+  bool loadBytes();
+
+  Source m_source;
+  int m_size;
+  Bytes m_bytes; // null owner until loaded
+  // null for the default ranges, shared with the atlases being built
+  std::shared_ptr<const GlyphRanges> m_glyphRanges;
+  GlyphRequests::ASCIISet m_missingASCII; // from the glyph subset
+  bool m_distanceField;
 };
 
 using ImGui_Font = Font; // user-facing alias
 
 class FontList {
 public:
-  FontList(TextureManager *);
+  FontList(ImGuiContext *, TextureManager *);
   ~FontList();
 
   void add(Font *);
   void remove(Font *);
   void update();
   void setScale(float scale);
+  // atlases may be shared by contexts but texture IDs are specific to each
+  void bindTexture() const;
   ImFontAtlas *getAtlas(float scale);
   bool removeAtlas(float scale);
   Font *get(ImFont *) const;
   ImFont *instanceOf(Font *) const;
+  bool withinFrame() const;
+  // of the atlases at every scale, which may be shared with other contexts
+  void stats(size_t *bytes, double *buildTime) const;
+  // changes when the fonts or glyphs of any atlas may have changed
+  // (not when switching between the atlases of different scales)
+  uint64_t version() const;
 
 private:
-  void invalidate();
-  void build(float scale);
-  void migrateActiveFonts();
-  ImFont *toCurrentAtlas(ImFont *) const;
+  struct Instance {
+    // shared is never null: instances are added once their atlas is built
+    std::shared_ptr<SharedAtlas> shared, pending;
+    std::vector<size_t> textures; // of each page
+  };
+
+  // texture user of a page of the atlas at a scale, kept until destruction
+  struct Page {
+    FontList *list;
+    float scale;
+    size_t index;
+
+    // null if the page no longer exists
+    const SharedAtlas *shared() const;
+  };
+
+  static const unsigned char *getPixels(void *object, float scale,
+                                        int *width, int *height);
+  static Texture::Format format(void *object, float scale);
+  static bool changes(void *object, float scale, unsigned int since,
+                      Texture::Region *);
+  static bool isPageValid(void *object);
+  static bool removeScale(void *object, float scale);
 
+  void invalidate();
+  bool append(Font *);
+  void swapAtlases();
+  Page *page(float scale, size_t index);
+  void touch(float scale, Instance &);
+  const SharedAtlas *current() const;
+  void migrateActiveFonts(const SharedAtlas *from);
+  ImFont *toCurrentAtlas(ImFont *, const SharedAtlas *from) const;
+
+  ImGuiContext *m_imgui;
   TextureManager *m_textureManager;
   std::vector<Font *> m_fonts;
-  std::unordered_map<float, std::unique_ptr<ImFontAtlas>> m_atlases;
-  bool m_rebuild;
+  // in the current and pending atlases, in the same order
+  std::vector<Font *> m_activeFonts, m_pendingFonts;
+  std::unordered_map<float, Instance> m_atlases;
+  std::map<std::pair<float, size_t>, Page> m_pages;
+  float m_scale; // of the atlas in io.Fonts
+  unsigned int m_replacements; // of atlases rebuilt or removed
+  // when to rebuild without the detached fonts, max if none
+  std::chrono::steady_clock::time_point m_compactAt;
+  bool m_rebuild, m_rebuilding;
 };
 
 #endif
@@ -0,0 +1,373 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "font_cache.hpp"
+
+#include "error.hpp"
+#include "file_buffer.hpp"
+#include "glyph_cache.hpp"
+#include "win32_unicode.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <imgui/imgui.h>
+#include <imgui/imgui_internal.h> // ImHashData
+#include <reaper_plugin_functions.h>
+#include <WDL/wdltypes.h>
+
+#ifdef _WIN32
+#  include <windows.h>
+#  include <sys/utime.h>
+#else
+#  include <dirent.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  include <utime.h>
+#endif
+
+// increment when changing the file layout or how fonts are built
+constexpr uint32_t FORMAT_VERSION { 1 };
+constexpr char MAGIC[] { 'R', 'I', 'F', 'C' };
+constexpr char EXTENSION[] { ".atlas" }, TEMP_EXTENSION[] { ".tmp" };
+// the least recently used atlases are removed past this total size
+constexpr uint64_t MAX_CACHE_SIZE { 256ull << 20 };
+// left behind by a crash or a full disk if not renamed after this long
+constexpr time_t STALE_TEMP_AGE { 60 * 60 };
+
+namespace {
+  class Writer {
+  public:
+    void write(const void *data, const size_t size)
+    {
+      const auto bytes { static_cast<const unsigned char *>(data) };
+      m_data.insert(m_data.end(), bytes, bytes + size);
+    }
+
+    template<typename T>
+    void write(const T &value) { write(&value, sizeof(value)); }
+
+    const std::vector<unsigned char> &data() const { return m_data; }
+
+  private:
+    std::vector<unsigned char> m_data;
+  };
+
+  class Reader {
+  public:
+    Reader(const unsigned char *data, const size_t size)
+      : m_pos { data }, m_end { data + size } {}
+
+    const unsigned char *read(const size_t size)
+    {
+      if(static_cast<size_t>(m_end - m_pos) < size)
+        throw reascript_error { "truncated font cache file" };
+      const unsigned char *data { m_pos };
+      m_pos += size;
+      return data;
+    }
+
+    template<typename T>
+    T read()
+    {
+      T value;
+      memcpy(&value, read(sizeof(value)), sizeof(value));
+      return value;
+    }
+
+    bool atEnd() const { return m_pos == m_end; }
+
+  private:
+    const unsigned char *m_pos, *m_end;
+  };
+
+  struct File {
+    std::string path;
+    uint64_t size;
+    time_t modified;
+  };
+}
+
+static bool endsWith(const std::string &string, const char *suffix)
+{
+  const size_t length { strlen(suffix) };
+  return string.size() >= length &&
+    !string.compare(string.size() - length, length, suffix);
+}
+
+static std::vector<File> listFiles(const std::string &directory)
+{
+  std::vector<File> files;
+
+#ifdef _WIN32
+  WIN32_FIND_DATAW data;
+  const HANDLE find
+    { FindFirstFileW(WIDEN(directory + WDL_DIRCHAR_STR "*"), &data) };
+  if(find == INVALID_HANDLE_VALUE)
+    return files;
+  do {
+    if(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+      continue;
+    const uint64_t size
+      { (uint64_t { data.nFileSizeHigh } << 32) | data.nFileSizeLow };
+    const uint64_t modified // in 100ns intervals since 1601
+      { (uint64_t { data.ftLastWriteTime.dwHighDateTime } << 32) |
+        data.ftLastWriteTime.dwLowDateTime };
+    files.push_back({ directory + WDL_DIRCHAR_STR + narrow(data.cFileName),
+      size, static_cast<time_t>(modified / 10'000'000 - 11'644'473'600) });
+  } while(FindNextFileW(find, &data));
+  FindClose(find);
+#else
+  DIR *dir { opendir(directory.c_str()) };
+  if(!dir)
+    return files;
+  while(const dirent *entry { readdir(dir) }) {
+    std::string path { directory + WDL_DIRCHAR_STR + entry->d_name };
+    struct stat info;
+    if(!stat(path.c_str(), &info) && S_ISREG(info.st_mode)) {
+      files.push_back({ std::move(path),
+        static_cast<uint64_t>(info.st_size), info.st_mtime });
+    }
+  }
+  closedir(dir);
+#endif
+
+  return files;
+}
+
+static void removeFile(const std::string &path)
+{
+#ifdef _WIN32
+  _wremove(WIDEN(path));
+#else
+  remove(path.c_str());
+#endif
+}
+
+static void touchFile(const std::string &path)
+{
+#ifdef _WIN32
+  _wutime(WIDEN(path), nullptr);
+#else
+  utime(path.c_str(), nullptr);
+#endif
+}
+
+static unsigned int processId()
+{
+#ifdef _WIN32
+  return GetCurrentProcessId();
+#else
+  return getpid();
+#endif
+}
+
+FontCache::Key::Key(const float scale)
+{
+  add(FORMAT_VERSION);
+  add(IMGUI_VERSION_NUM);
+  add(sizeof(ImFontGlyph));
+  add(GlyphRasterizer::libraryVersion());
+  add(GlyphRasterizer::DISTANCE_FIELD_SPREAD);
+  add(scale);
+}
+
+void FontCache::Key::add(const void *data, const size_t size)
+{
+  const auto bytes { static_cast<const unsigned char *>(data) };
+  m_data.insert(m_data.end(), bytes, bytes + size);
+}
+
+FontCache &FontCache::get()
+{
+  static FontCache cache;
+  return cache;
+}
+
+FontCache::FontCache()
+  : m_directory { GetResourcePath() }
+{
+  m_directory += WDL_DIRCHAR_STR "ReaImGui" WDL_DIRCHAR_STR "font_cache";
+  // here in the main thread as atlases are built by workers
+  RecursiveCreateDirectory(m_directory.c_str(), 0);
+}
+
+std::string FontCache::filename(const Key &key) const
+{
+  char name[32];
+  snprintf(name, sizeof(name), WDL_DIRCHAR_STR "%08X%s",
+    ImHashData(key.data().data(), key.data().size()), EXTENSION);
+  return m_directory + name;
+}
+
+bool FontCache::load(ImFontAtlas *atlas, const Key &key) const
+try {
+  const std::string path { filename(key) };
+  touchFile(path); // for evict
+  const FileBuffer file { path.c_str() };
+  Reader reader { file.data(), file.size() };
+
+  // the file name is only a hash of the key
+  const std::vector<unsigned char> &keyData { key.data() };
+  if(memcmp(reader.read(sizeof(MAGIC)), MAGIC, sizeof(MAGIC)) ||
+      reader.read<uint64_t>() != keyData.size() ||
+      memcmp(reader.read(keyData.size()), keyData.data(), keyData.size()))
+    return false;
+
+  atlas->Clear();
+  atlas->TexWidth           = reader.read<int>();
+  atlas->TexHeight          = reader.read<int>();
+  atlas->TexUvScale         = reader.read<ImVec2>();
+  atlas->TexUvWhitePixel    = reader.read<ImVec2>();
+  atlas->TexPixelsUseColors = reader.read<bool>();
+  for(ImVec4 &uv : atlas->TexUvLines)
+    uv = reader.read<ImVec4>();
+
+  for(int fontCount { reader.read<int>() }; fontCount > 0; --fontCount) {
+    ImFont *font { IM_NEW(ImFont) };
+    atlas->Fonts.push_back(font);
+    font->ContainerAtlas      = atlas;
+    font->FontSize            = reader.read<float>();
+    font->Ascent              = reader.read<float>();
+    font->Descent             = reader.read<float>();
+    font->Scale               = reader.read<float>();
+    font->MetricsTotalSurface = reader.read<int>();
+
+    const int glyphCount { reader.read<int>() };
+    const size_t glyphsSize { sizeof(ImFontGlyph) * glyphCount };
+    font->Glyphs.resize(glyphCount);
+    memcpy(font->Glyphs.Data, reader.read(glyphsSize), glyphsSize);
+    font->BuildLookupTable();
+  }
+
+  const size_t pixelsSize { static_cast<size_t>(atlas->TexWidth) *
+                            atlas->TexHeight * 4 };
+  atlas->TexPixelsRGBA32 = static_cast<unsigned int *>(IM_ALLOC(pixelsSize));
+  memcpy(atlas->TexPixelsRGBA32, reader.read(pixelsSize), pixelsSize);
+  atlas->TexReady = true;
+
+  if(!reader.atEnd()) {
+    atlas->Clear();
+    return false;
+  }
+
+  return true;
+}
+catch(const reascript_error &) {
+  atlas->Clear();
+  return false;
+}
+
+void FontCache::save(ImFontAtlas *atlas, const Key &key) const
+{
+  // without converting the atlas back to RGBA, see DynamicGlyphs::format
+  const int width { atlas->TexWidth }, height { atlas->TexHeight };
+  const size_t pixelCount { static_cast<size_t>(width) * height };
+  std::vector<unsigned int> rgba;
+  const void *pixels { atlas->TexPixelsRGBA32 };
+  if(!pixels) {
+    rgba.resize(pixelCount);
+    for(size_t i {}; i < pixelCount; ++i)
+      rgba[i] = IM_COL32(255, 255, 255, atlas->TexPixelsAlpha8[i]);
+    pixels = rgba.data();
+  }
+
+  Writer writer;
+  writer.write(MAGIC, sizeof(MAGIC));
+  writer.write<uint64_t>(key.data().size());
+  writer.write(key.data().data(), key.data().size());
+
+  writer.write(atlas->TexWidth);
+  writer.write(atlas->TexHeight);
+  writer.write(atlas->TexUvScale);
+  writer.write(atlas->TexUvWhitePixel);
+  writer.write(atlas->TexPixelsUseColors);
+  for(const ImVec4 &uv : atlas->TexUvLines)
+    writer.write(uv);
+
+  writer.write(atlas->Fonts.Size);
+  for(const ImFont *font : atlas->Fonts) {
+    writer.write(font->FontSize);
+    writer.write(font->Ascent);
+    writer.write(font->Descent);
+    writer.write(font->Scale);
+    writer.write(font->MetricsTotalSurface);
+    writer.write(font->Glyphs.Size);
+    writer.write(font->Glyphs.Data, sizeof(ImFontGlyph) * font->Glyphs.Size);
+  }
+
+  writer.write(pixels, pixelCount * 4);
+
+  // write to a temporary file first so that other instances of REAPER
+  // never read a partially written atlas
+  static std::atomic<unsigned int> g_tempFiles;
+  const std::string path { filename(key) }, tempPath { path + '.' +
+    std::to_string(processId()) + '-' + std::to_string(++g_tempFiles) +
+    TEMP_EXTENSION };
+#ifdef _WIN32
+  FILE *file { _wfopen(WIDEN(tempPath), L"wb") };
+#else
+  FILE *file { fopen(tempPath.c_str(), "wb") };
+#endif
+  if(!file)
+    return; // the cache is optional
+
+  const std::vector<unsigned char> &data { writer.data() };
+  const bool ok { fwrite(data.data(), 1, data.size(), file) == data.size() };
+  if(fclose(file) || !ok) {
+    removeFile(tempPath);
+    return;
+  }
+
+#ifdef _WIN32
+  const bool renamed
+    { !!MoveFileExW(WIDEN(tempPath), WIDEN(path), MOVEFILE_REPLACE_EXISTING) };
+#else
+  const bool renamed { !rename(tempPath.c_str(), path.c_str()) };
+#endif
+  if(!renamed)
+    removeFile(tempPath);
+
+  evict();
+}
+
+void FontCache::evict() const
+{
+  std::vector<File> files { listFiles(m_directory) };
+  std::sort(files.begin(), files.end(), [](const File &a, const File &b) {
+    return a.modified > b.modified; // most recently used first
+  });
+
+  const time_t now { time(nullptr) };
+  uint64_t totalSize {};
+  for(const File &file : files) {
+    if(endsWith(file.path, TEMP_EXTENSION)) {
+      // may still be written by another instance of REAPER
+      if(now - file.modified > STALE_TEMP_AGE)
+        removeFile(file.path);
+    }
+    else if(endsWith(file.path, EXTENSION)) {
+      // always keep the most recent atlas even if it's larger than the limit
+      if(totalSize && totalSize + file.size > MAX_CACHE_SIZE)
+        removeFile(file.path);
+      else
+        totalSize += file.size;
+    }
+  }
+}
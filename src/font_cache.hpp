@@ -0,0 +1,67 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAIMGUI_FONT_CACHE_HPP
+#define REAIMGUI_FONT_CACHE_HPP
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+struct ImFontAtlas;
+
+// Built font atlases (pixels and glyph tables) stored in REAPER's resource
+// directory to skip rasterizing the same fonts again in later sessions.
+class FontCache {
+public:
+  // everything affecting the output of ImFontAtlas::Build
+  class Key {
+  public:
+    Key(float scale);
+
+    void add(const void *data, size_t size);
+    template<typename T>
+    void add(const T &value)
+    {
+      static_assert(std::is_trivially_copyable_v<T>);
+      add(&value, sizeof(value));
+    }
+
+    const std::vector<unsigned char> &data() const { return m_data; }
+
+  private:
+    std::vector<unsigned char> m_data;
+  };
+
+  // to be first called from the main thread, load and save are thread-safe
+  static FontCache &get();
+
+  FontCache();
+
+  // replaces the contents of the atlas, false if not found
+  bool load(ImFontAtlas *, const Key &) const;
+  void save(ImFontAtlas *, const Key &) const;
+
+private:
+  std::string filename(const Key &) const;
+  // removes the least recently used atlases past the maximum size
+  void evict() const;
+
+  std::string m_directory;
+};
+
+#endif
@@ -0,0 +1,550 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "glyph_cache.hpp"
+
+#include "error.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_MODULE_H
+#include FT_SYNTHESIS_H
+#include <imgui/imgui.h>
+#include <imgui/imgui_internal.h>
+#include <imgui/misc/freetype/imgui_freetype.h>
+
+// glyphs not used for this long are dropped when the atlas is full
+constexpr std::chrono::seconds EVICT_AFTER { 30 };
+constexpr int MAX_ATLAS_HEIGHT { 4096 };
+
+#if FREETYPE_MAJOR > 2 || (FREETYPE_MAJOR == 2 && FREETYPE_MINOR >= 11)
+#  define HAS_DISTANCE_FIELDS
+#endif
+
+// creating and destroying faces is not thread-safe (atlases are built by
+// workers while the main thread rasterizes glyphs on demand)
+static std::mutex g_libraryMutex;
+
+static FT_Library library()
+{
+  static FT_Library instance {};
+  if(instance)
+    return instance;
+  if(FT_Init_FreeType(&instance))
+    throw reascript_error { "failed to initialize FreeType" };
+#ifdef HAS_DISTANCE_FIELDS
+  // the default, set explicitly as DynamicGlyphs and the cache depend on it
+  const FT_Int spread { GlyphRasterizer::DISTANCE_FIELD_SPREAD };
+  FT_Property_Set(instance, "sdf", "spread", &spread);
+#endif
+  return instance;
+}
+
+GlyphRequests &GlyphRequests::get()
+{
+  static GlyphRequests instance;
+  return instance;
+}
+
+void GlyphRequests::addUTF8(const char *text)
+{
+  const auto now { Clock::now() };
+
+  const char *end { text + strlen(text) };
+  while(text < end) {
+    unsigned int codepoint;
+    text += ImTextCharFromUtf8(&codepoint, text, end);
+    if((codepoint < 0x80 && !isMissingASCII(codepoint)) ||
+        codepoint == IM_UNICODE_CODEPOINT_INVALID)
+      continue;
+
+    const auto [it, isNew] { m_lastUse.try_emplace(codepoint, now) };
+    if(isNew)
+      m_list.push_back(codepoint);
+    else
+      it->second = now;
+  }
+}
+
+void GlyphRequests::addASCIISubset(const ASCIISet &missing)
+{
+  for(size_t c {}; c < missing.size(); ++c) {
+    if(missing[c] && !m_missingASCIIFonts[c]++)
+      m_missingASCII[c >> 6] |= uint64_t { 1 } << (c & 63);
+  }
+}
+
+void GlyphRequests::removeASCIISubset(const ASCIISet &missing)
+{
+  for(size_t c {}; c < missing.size(); ++c) {
+    if(missing[c] && !--m_missingASCIIFonts[c])
+      m_missingASCII[c >> 6] &= ~(uint64_t { 1 } << (c & 63));
+  }
+}
+
+std::vector<unsigned int> GlyphRequests::recent() const
+{
+  std::vector<unsigned int> codepoints;
+  std::copy_if(m_list.begin(), m_list.end(), std::back_inserter(codepoints),
+    [this](const unsigned int codepoint) { return isRecent(codepoint); });
+  return codepoints;
+}
+
+bool GlyphRequests::isRecent(const unsigned int codepoint) const
+{
+  const auto it { m_lastUse.find(codepoint) };
+  return it != m_lastUse.end() && Clock::now() - it->second < EVICT_AFTER;
+}
+
+bool GlyphRasterizer::supportsDistanceFields()
+{
+#ifdef HAS_DISTANCE_FIELDS
+  return true;
+#else
+  return false;
+#endif
+}
+
+unsigned int GlyphRasterizer::libraryVersion()
+{
+  static const unsigned int version { [] {
+    std::lock_guard<std::mutex> lock { g_libraryMutex };
+    FT_Int major, minor, patch;
+    FT_Library_Version(library(), &major, &minor, &patch);
+    return static_cast<unsigned int>((major << 16) | (minor << 8) | patch);
+  }() };
+  return version;
+}
+
+GlyphRasterizer::GlyphRasterizer(const ImFontConfig &cfg,
+    std::shared_ptr<const void> owner, const bool distanceField)
+  : m_owner { std::move(owner) }, m_face {},
+    m_builderFlags { cfg.FontBuilderFlags }, m_loadFlags { FT_LOAD_NO_BITMAP },
+    m_distanceField { distanceField }
+{
+  if(m_distanceField && !supportsDistanceFields())
+    throw reascript_error { "distance fields require FreeType 2.11" };
+
+  {
+    std::lock_guard<std::mutex> lock { g_libraryMutex };
+    if(FT_New_Memory_Face(library(), static_cast<FT_Byte *>(cfg.FontData),
+        cfg.FontDataSize, cfg.FontNo, &m_face))
+      throw reascript_error { "failed to load the font face" };
+  }
+
+  FT_Select_Charmap(m_face, FT_ENCODING_UNICODE);
+
+  FT_Size_RequestRec req {};
+  req.type   = FT_SIZE_REQUEST_TYPE_REAL_DIM;
+  req.height = static_cast<FT_Long>(cfg.SizePixels) * 64;
+  FT_Request_Size(m_face, &req);
+
+  if(m_builderFlags & ImGuiFreeTypeBuilderFlags_NoHinting)
+    m_loadFlags |= FT_LOAD_NO_HINTING;
+  if(m_builderFlags & ImGuiFreeTypeBuilderFlags_LightHinting)
+    m_loadFlags |= FT_LOAD_TARGET_LIGHT;
+  else
+    m_loadFlags |= FT_LOAD_TARGET_NORMAL;
+  if(m_builderFlags & ImGuiFreeTypeBuilderFlags_LoadColor)
+    m_loadFlags |= FT_LOAD_COLOR;
+}
+
+GlyphRasterizer::GlyphRasterizer()
+  : m_face {}, m_builderFlags {}, m_loadFlags {}, m_distanceField { false }
+{
+}
+
+GlyphRasterizer::~GlyphRasterizer()
+{
+  std::lock_guard<std::mutex> lock { g_libraryMutex };
+  if(m_face)
+    FT_Done_Face(m_face);
+}
+
+void GlyphRasterizer::verticalMetrics(float *ascent, float *descent) const
+{
+  // FT_CEIL from imgui_freetype
+  constexpr auto ceil { [](const FT_Pos x) { return ((x + 63) & -64) / 64; } };
+  const FT_Size_Metrics &metrics { m_face->size->metrics };
+  *ascent  = static_cast<float>(ceil(metrics.ascender));
+  *descent = static_cast<float>(ceil(metrics.descender));
+}
+
+bool GlyphRasterizer::render(const unsigned int codepoint, Metrics *metrics)
+{
+  const FT_UInt index { FT_Get_Char_Index(m_face, codepoint) };
+  if(!index || FT_Load_Glyph(m_face, index, m_loadFlags))
+    return false;
+
+  FT_GlyphSlot slot { m_face->glyph };
+  if(slot->format != FT_GLYPH_FORMAT_OUTLINE)
+    return false;
+  if(m_builderFlags & ImGuiFreeTypeBuilderFlags_Bold)
+    FT_GlyphSlot_Embolden(slot);
+  if(m_builderFlags & ImGuiFreeTypeBuilderFlags_Oblique)
+    FT_GlyphSlot_Oblique(slot);
+#ifdef HAS_DISTANCE_FIELDS
+  const FT_Render_Mode mode
+    { m_distanceField ? FT_RENDER_MODE_SDF : FT_RENDER_MODE_NORMAL };
+#else
+  const FT_Render_Mode mode { FT_RENDER_MODE_NORMAL };
+#endif
+  if(FT_Render_Glyph(slot, mode))
+    return false;
+
+  const FT_Bitmap &bitmap { slot->bitmap };
+  metrics->width    = bitmap.width;
+  metrics->height   = bitmap.rows;
+  metrics->offsetX  = slot->bitmap_left;
+  metrics->offsetY  = -slot->bitmap_top;
+  // distance fields are scaled, rounding at their size would add up
+  metrics->advanceX = m_distanceField ? slot->advance.x / 64.f :
+                      static_cast<float>((slot->advance.x + 63) / 64);
+  metrics->colored  = bitmap.pixel_mode == FT_PIXEL_MODE_BGRA;
+  return bitmap.pixel_mode == FT_PIXEL_MODE_GRAY || metrics->colored;
+}
+
+void GlyphRasterizer::copyTo(unsigned char *pixels, const size_t stride,
+  const bool alphaOnly) const
+{
+  const FT_Bitmap &bitmap { m_face->glyph->bitmap };
+  const unsigned char *src { bitmap.buffer };
+
+  for(unsigned int y {}; y < bitmap.rows; ++y) {
+    unsigned char *dst { pixels + (y * stride) };
+    if(alphaOnly) {
+      std::memcpy(dst, src, bitmap.width);
+      src += bitmap.pitch;
+      continue;
+    }
+    for(unsigned int x {}; x < bitmap.width; ++x, dst += 4) {
+      if(bitmap.pixel_mode == FT_PIXEL_MODE_GRAY) {
+        dst[0] = dst[1] = dst[2] = 0xFF;
+        dst[3] = src[x];
+        continue;
+      }
+
+      // premultiplied BGRA
+      const unsigned char *bgra { &src[x * 4] };
+      const float alpha { bgra[3] + FLT_MIN };
+      dst[0] = static_cast<unsigned char>((255.f * bgra[2] / alpha) + .5f);
+      dst[1] = static_cast<unsigned char>((255.f * bgra[1] / alpha) + .5f);
+      dst[2] = static_cast<unsigned char>((255.f * bgra[0] / alpha) + .5f);
+      dst[3] = bgra[3];
+    }
+    src += bitmap.pitch;
+  }
+}
+
+DynamicGlyphs::DynamicGlyphs(ImFontAtlas *atlas, const bool distanceField)
+  : m_atlas { atlas }, m_distanceField { distanceField },
+    m_shelfX {}, m_shelfHeight {}
+{
+  unsigned char *pixels;
+  int width, height;
+  atlas->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+  // new glyphs go below everything packed by ImFontAtlas::Build
+  float bottom { atlas->TexUvWhitePixel.y };
+  for(const ImVec4 &line : atlas->TexUvLines)
+    bottom = std::max(bottom, line.w);
+  for(const ImFont *font : atlas->Fonts) {
+    for(const ImFontGlyph &glyph : font->Glyphs)
+      bottom = std::max(bottom, glyph.V1);
+  }
+  m_shelfY = static_cast<int>((bottom * height) + .5f) +
+             atlas->TexGlyphPadding;
+
+  // a quarter of the memory and upload bandwidth without color glyphs
+  const bool colored { std::any_of(atlas->Fonts.begin(), atlas->Fonts.end(),
+    [](const ImFont *font) {
+      return std::any_of(font->Glyphs.begin(), font->Glyphs.end(),
+        [](const ImFontGlyph &glyph) { return glyph.Colored; });
+    }) };
+  if(m_distanceField || !colored)
+    toAlpha8();
+}
+
+DynamicGlyphs::~DynamicGlyphs() = default;
+
+void DynamicGlyphs::addFont(ImFont *instance,
+  GlyphRasterizer::Factory factory)
+{
+  m_targets.push_back({ instance, std::move(factory), nullptr, false });
+}
+
+ImFont *DynamicGlyphs::createFont(GlyphRasterizer::Factory factory,
+  const float size)
+{
+  std::unique_ptr<GlyphRasterizer> rasterizer { factory() };
+  if(!rasterizer)
+    return nullptr;
+
+  // same setup as ImFontAtlasBuildSetupFont, without the input config data
+  ImFont *instance { IM_NEW(ImFont) };
+  instance->FontSize = size;
+  instance->ContainerAtlas = m_atlas;
+  rasterizer->verticalMetrics(&instance->Ascent, &instance->Descent);
+  m_atlas->Fonts.push_back(instance);
+
+  m_targets.push_back
+    ({ instance, std::move(factory), std::move(rasterizer), false });
+  return instance;
+}
+
+auto DynamicGlyphs::add(const std::vector<unsigned int> &codepoints,
+    const size_t first, const bool canGrow, Texture::Region *region,
+    const ImFont *only) -> Status
+{
+  Status status { Done };
+
+  for(Target &target : m_targets) {
+    ImFont *instance { target.instance };
+    if(target.failed || (only && instance != only))
+      continue;
+
+    // ImFont::BuildLookupTable appends a tab glyph at the end
+    const bool hadTab
+      { !instance->Glyphs.empty() && instance->Glyphs.back().Codepoint == '\t' };
+    bool tabRemoved {};
+
+    for(size_t i { first }; i < codepoints.size(); ++i) {
+      const unsigned int codepoint { codepoints[i] };
+      if(codepoint > IM_UNICODE_CODEPOINT_MAX ||
+          instance->FindGlyphNoFallback(codepoint))
+        continue;
+
+      if(hadTab && !tabRemoved) {
+        instance->Glyphs.resize(instance->Glyphs.Size - 1);
+        tabRemoved = true;
+      }
+      if(!addGlyph(target, codepoint, canGrow, region, &status))
+        break;
+    }
+
+    if(tabRemoved || instance->DirtyLookupTables)
+      instance->BuildLookupTable();
+
+    if(status != Done)
+      break;
+  }
+
+  return status;
+}
+
+bool DynamicGlyphs::addGlyph(Target &target, const unsigned int codepoint,
+  const bool canGrow, Texture::Region *region, Status *status)
+{
+  if(!target.rasterizer) {
+    target.rasterizer = target.factory();
+    if(!target.rasterizer) {
+      target.failed = true;
+      return false;
+    }
+  }
+
+  GlyphRasterizer::Metrics metrics;
+  if(!target.rasterizer->render(codepoint, &metrics))
+    return true; // not in this font, use the fallback glyph
+
+  int x {}, y {};
+  if(metrics.width > 0 && metrics.height > 0) {
+    if(!allocate(metrics.width, metrics.height, &x, &y,
+        canGrow, region, status))
+      return *status == Done; // leave out glyphs wider than the atlas
+
+    if(metrics.colored && !m_atlas->TexPixelsRGBA32) {
+      toRGBA32();
+      *region = { 0, 0, m_atlas->TexWidth, m_atlas->TexHeight };
+    }
+
+    const bool alphaOnly { !m_atlas->TexPixelsRGBA32 };
+    const size_t bpp { static_cast<size_t>(Texture::bytesPerPixel(format())) },
+                 stride { m_atlas->TexWidth * bpp };
+    unsigned char *pixels { alphaOnly ? m_atlas->TexPixelsAlpha8 :
+      reinterpret_cast<unsigned char *>(m_atlas->TexPixelsRGBA32) };
+    target.rasterizer->copyTo(&pixels[(y * stride) + (x * bpp)],
+                              stride, alphaOnly);
+    region->extend({ x, y, x + metrics.width, y + metrics.height });
+  }
+
+  ImFont *instance { target.instance };
+  const float x0 { static_cast<float>(metrics.offsetX) },
+              y0 { metrics.offsetY + IM_ROUND(instance->Ascent) };
+  const ImVec2 uvScale { m_atlas->TexUvScale };
+  instance->AddGlyph(nullptr, codepoint, x0, y0,
+    x0 + metrics.width, y0 + metrics.height,
+    x * uvScale.x, y * uvScale.y,
+    (x + metrics.width) * uvScale.x, (y + metrics.height) * uvScale.y,
+    metrics.advanceX);
+  instance->Glyphs.back().Colored = metrics.colored;
+  m_added.push_back(codepoint);
+
+  return true;
+}
+
+bool DynamicGlyphs::allocate(const int width, const int height,
+  int *x, int *y, const bool canGrow, Texture::Region *region, Status *status)
+{
+  const int padding { m_atlas->TexGlyphPadding },
+            paddedWidth { width + padding }, paddedHeight { height + padding };
+  if(paddedWidth > m_atlas->TexWidth)
+    return false;
+
+  if(m_shelfX + paddedWidth > m_atlas->TexWidth) {
+    m_shelfX = 0;
+    m_shelfY += m_shelfHeight;
+    m_shelfHeight = 0;
+  }
+
+  while(m_shelfY + paddedHeight > m_atlas->TexHeight) {
+    if(!canGrow) {
+      *status = Postponed;
+      return false;
+    }
+    else if(!grow()) {
+      *status = Full;
+      return false;
+    }
+    *region = { 0, 0, m_atlas->TexWidth, m_atlas->TexHeight };
+  }
+
+  *x = m_shelfX, *y = m_shelfY;
+  m_shelfX += paddedWidth;
+  m_shelfHeight = std::max(m_shelfHeight, paddedHeight);
+  return true;
+}
+
+bool DynamicGlyphs::grow()
+{
+  const int oldHeight { m_atlas->TexHeight }, newHeight { oldHeight * 2 };
+  if(newHeight > MAX_ATLAS_HEIGHT)
+    return false;
+
+  const bool alphaOnly { !m_atlas->TexPixelsRGBA32 };
+  const size_t rowSize
+    { m_atlas->TexWidth * static_cast<size_t>(Texture::bytesPerPixel(format())) };
+  auto pixels { static_cast<unsigned char *>(IM_ALLOC(rowSize * newHeight)) };
+  unsigned char *oldPixels { alphaOnly ? m_atlas->TexPixelsAlpha8 :
+    reinterpret_cast<unsigned char *>(m_atlas->TexPixelsRGBA32) };
+  std::memcpy(pixels, oldPixels, rowSize * oldHeight);
+  std::memset(pixels + (rowSize * oldHeight), 0, rowSize * (newHeight - oldHeight));
+  IM_FREE(oldPixels);
+  if(alphaOnly)
+    m_atlas->TexPixelsAlpha8 = pixels;
+  else
+    m_atlas->TexPixelsRGBA32 = reinterpret_cast<unsigned int *>(pixels);
+
+  // texture coordinates are normalized
+  constexpr float ratio { .5f };
+  m_atlas->TexHeight = newHeight;
+  m_atlas->TexUvScale.y *= ratio;
+  m_atlas->TexUvWhitePixel.y *= ratio;
+  for(ImVec4 &line : m_atlas->TexUvLines)
+    line.y *= ratio, line.w *= ratio;
+  for(ImFont *font : m_atlas->Fonts) {
+    for(ImFontGlyph &glyph : font->Glyphs)
+      glyph.V0 *= ratio, glyph.V1 *= ratio;
+  }
+
+  return true;
+}
+
+Texture::Format DynamicGlyphs::format() const
+{
+  // GetTexDataAsRGBA32 would convert the atlas back, so it is not called
+  if(m_atlas->TexPixelsRGBA32)
+    return Texture::RGBA8;
+  return m_distanceField ? Texture::Distance8 : Texture::Alpha8;
+}
+
+void DynamicGlyphs::toAlpha8()
+{
+  const size_t size { static_cast<size_t>(m_atlas->TexWidth) *
+                      m_atlas->TexHeight };
+  auto alpha { static_cast<unsigned char *>(IM_ALLOC(size)) };
+  const auto *rgba
+    { reinterpret_cast<const unsigned char *>(m_atlas->TexPixelsRGBA32) };
+  for(size_t i {}; i < size; ++i)
+    alpha[i] = rgba[(i * 4) + 3];
+
+  IM_FREE(m_atlas->TexPixelsAlpha8);
+  IM_FREE(m_atlas->TexPixelsRGBA32);
+  m_atlas->TexPixelsAlpha8 = alpha;
+  m_atlas->TexPixelsRGBA32 = nullptr;
+}
+
+void DynamicGlyphs::toRGBA32()
+{
+  const size_t size { static_cast<size_t>(m_atlas->TexWidth) *
+                      m_atlas->TexHeight };
+  auto rgba { static_cast<unsigned char *>(IM_ALLOC(size * 4)) };
+  const unsigned char *alpha { m_atlas->TexPixelsAlpha8 };
+  for(size_t i {}; i < size; ++i) {
+    unsigned char *dst { &rgba[i * 4] };
+    dst[0] = dst[1] = dst[2] = 0xFF;
+    dst[3] = alpha[i];
+  }
+
+  IM_FREE(m_atlas->TexPixelsAlpha8);
+  m_atlas->TexPixelsAlpha8 = nullptr;
+  m_atlas->TexPixelsRGBA32 = reinterpret_cast<unsigned int *>(rgba);
+}
+
+bool DynamicGlyphs::evictable() const
+{
+  const GlyphRequests &requests { GlyphRequests::get() };
+  return std::any_of(m_added.begin(), m_added.end(),
+    [&requests](const unsigned int codepoint) {
+      return !requests.isRecent(codepoint);
+    });
+}
+
+int AtlasPages::distanceFieldWidth(const size_t area)
+{
+  // ImFontAtlas::Build only sees the space characters
+  int width { 512 };
+  while(width < 4096 && static_cast<size_t>(width) * width < area)
+    width *= 2;
+  return width;
+}
+
+AtlasPages::AtlasPages(const size_t maxArea, const size_t defaultFontArea)
+  : m_maxArea { maxArea }, m_pages { { false, defaultFontArea, {} } }
+{
+}
+
+void AtlasPages::add(const size_t font, const bool distanceField,
+  const size_t area)
+{
+  auto page { std::find_if(m_pages.rbegin(), m_pages.rend(),
+    [distanceField](const Page &other) {
+      return other.distanceField == distanceField;
+    }) };
+  if(page == m_pages.rend() ||
+      (page->area + area > m_maxArea && !page->fonts.empty())) {
+    m_pages.push_back({ distanceField, 0, {} });
+    page = m_pages.rbegin();
+  }
+  page->fonts.push_back(font);
+  page->area += area;
+}
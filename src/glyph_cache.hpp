@@ -0,0 +1,196 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAIMGUI_GLYPH_CACHE_HPP
+#define REAIMGUI_GLYPH_CACHE_HPP
+
+#include "texture.hpp"
+
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+struct FT_FaceRec_;
+struct ImFont;
+struct ImFontAtlas;
+struct ImFontConfig;
+
+// Characters found in the text given to the API. Glyphs outside of the
+// ranges built upfront are rasterized the first time they are requested.
+class GlyphRequests {
+public:
+  using ASCIISet = std::bitset<0x80>;
+
+  static GlyphRequests &get();
+
+  static void add(const char *text)
+  {
+    // skip ASCII characters quickly, they are built upfront
+    // unless a font was created without some of them
+    const GlyphRequests &requests { get() };
+    for(const char *p { text }; p && *p; ++p) {
+      const unsigned char c { static_cast<unsigned char>(*p) };
+      if(c >= 0x80 || requests.isMissingASCII(c))
+        return get().addUTF8(p);
+    }
+  }
+
+  // for the lifetime of fonts built without some ASCII characters
+  void addASCIISubset(const ASCIISet &missing);
+  void removeASCIISubset(const ASCIISet &missing);
+
+  // in order of first use
+  const std::vector<unsigned int> &list() const { return m_list; }
+  std::vector<unsigned int> recent() const;
+  bool isRecent(unsigned int codepoint) const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  void addUTF8(const char *);
+  bool isMissingASCII(const unsigned char c) const
+  {
+    return (m_missingASCII[c >> 6] >> (c & 63)) & 1;
+  }
+
+  std::vector<unsigned int> m_list;
+  std::unordered_map<unsigned int, Clock::time_point> m_lastUse;
+  // number of live fonts without each ASCII character, and a mask of
+  // the characters missing from any of them
+  unsigned int m_missingASCIIFonts[0x80];
+  uint64_t m_missingASCII[2];
+};
+
+// Renders individual glyphs the same way imgui_freetype does
+class GlyphRasterizer {
+public:
+  // creates a rasterizer on demand, null if the font data cannot be read
+  using Factory = std::function<std::unique_ptr<GlyphRasterizer>()>;
+
+  struct Metrics {
+    int width, height, offsetX, offsetY;
+    float advanceX;
+    bool colored;
+  };
+
+  // in pixels around the glyphs rendered as distance fields
+  static constexpr int DISTANCE_FIELD_SPREAD { 8 };
+  // FreeType can render signed distance fields since version 2.11
+  static bool supportsDistanceFields();
+  // of the FreeType library in use, for invalidating cached glyphs
+  static unsigned int libraryVersion();
+
+  // the owner keeps the font data alive for as long as the face is used
+  GlyphRasterizer(const ImFontConfig &, std::shared_ptr<const void> owner,
+                  bool distanceField = false);
+  GlyphRasterizer(const GlyphRasterizer &) = delete;
+  virtual ~GlyphRasterizer();
+
+  // rounded like imgui_freetype, descent is negative
+  virtual void verticalMetrics(float *ascent, float *descent) const;
+  // false if the font has no glyph for this character
+  virtual bool render(unsigned int codepoint, Metrics *);
+  // copies the last rendered glyph as RGBA, or only its coverage in a
+  // single byte per pixel (must not be colored)
+  virtual void copyTo(unsigned char *pixels, size_t stride, bool alphaOnly) const;
+
+protected:
+  GlyphRasterizer(); // without a font face, for subclasses
+
+private:
+  std::shared_ptr<const void> m_owner;
+  FT_FaceRec_ *m_face;
+  unsigned int m_builderFlags;
+  int m_loadFlags;
+  bool m_distanceField;
+};
+
+// Appends glyphs to an already built atlas in the free space of its texture
+class DynamicGlyphs {
+public:
+  // Postponed: the texture must grow but other users still need the old UVs
+  enum Status { Done, Postponed, Full };
+
+  // distance field atlases contain only glyphs from such rasterizers
+  DynamicGlyphs(ImFontAtlas *, bool distanceField = false);
+  ~DynamicGlyphs();
+
+  void addFont(ImFont *, GlyphRasterizer::Factory);
+  // creates a new empty font in the atlas, null if the data cannot be read
+  ImFont *createFont(GlyphRasterizer::Factory, float size);
+  // extends the region with the modified area (the whole texture if resized)
+  Status add(const std::vector<unsigned int> &codepoints, size_t first,
+             bool canGrow, Texture::Region *, const ImFont *only = nullptr);
+  // whether rebuilding the atlas would free space used by old glyphs
+  bool evictable() const;
+  // Alpha8 until a colored glyph is added, or Distance8
+  Texture::Format format() const;
+
+private:
+  struct Target {
+    ImFont *instance;
+    GlyphRasterizer::Factory factory;
+    std::unique_ptr<GlyphRasterizer> rasterizer;
+    bool failed;
+  };
+
+  bool addGlyph(Target &, unsigned int codepoint, bool canGrow,
+                Texture::Region *, Status *);
+  bool allocate(int width, int height, int *x, int *y, bool canGrow,
+                Texture::Region *, Status *);
+  bool grow();
+  void toAlpha8();
+  void toRGBA32();
+
+  ImFontAtlas *m_atlas;
+  bool m_distanceField;
+  std::vector<Target> m_targets;
+  std::vector<unsigned int> m_added;
+  int m_shelfX, m_shelfY, m_shelfHeight;
+};
+
+// Assignment of fonts to atlas pages (each with its own texture). A new page
+// is started once the glyphs built upfront would fill the last one.
+// Distance fields are sampled differently by the renderer, so they get pages
+// of their own.
+class AtlasPages {
+public:
+  struct Page {
+    bool distanceField;
+    size_t area; // estimated texture area used by the glyphs built upfront
+    std::vector<size_t> fonts;
+  };
+
+  // smallest power of two width from 512 to 4096 of a square page
+  static int distanceFieldWidth(size_t area);
+
+  // the first page holds the default font
+  AtlasPages(size_t maxArea, size_t defaultFontArea);
+
+  void add(size_t font, bool distanceField, size_t area);
+  const std::vector<Page> &pages() const { return m_pages; }
+
+private:
+  size_t m_maxArea;
+  std::vector<Page> m_pages;
+};
+
+#endif
@@ -18,13 +18,26 @@
 #include "image.hpp"
 
 #include "error.hpp"
+#include "file_buffer.hpp"
+#include "resample.hpp"
 #include "texture.hpp"
-#include "win32_unicode.hpp"
+#include "thread_pool.hpp"
+#include "tile_grid.hpp"
 
-#include <boost/iostreams/stream.hpp>
-#include <cmath> // abs
-#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath> // abs, isnan
+#include <cstdint>
 #include <imgui/imgui.h>
+#include <utility> // exchange
+
+// guaranteed to be supported by every renderer
+constexpr size_t MAX_TEXTURE_SIZE   { 8192 };
+constexpr size_t MAX_OVERVIEW_SIZE  { 2048 };
+constexpr size_t MAX_RESIDENT_TILES { 16 };
+
+constexpr std::chrono::milliseconds PROGRESS_INTERVAL { 100 };
 
 static const Image::RegisterType *&typeHead()
 {
@@ -38,77 +51,925 @@ Image::RegisterType::RegisterType(const TestFunc test, const CreateFunc create)
   typeHead() = this;
 }
 
-static Image *create(std::istream &stream)
+std::unique_ptr<Image::Decoder> Image::createDecoder(
+  const unsigned char *data, const size_t size)
 {
   for(const Image::RegisterType *type { typeHead() }; type; type = type->m_next) {
-    if(type->m_test(stream))
-      return type->m_create(stream);
-    else
-      stream.seekg(0);
+    if(type->m_test(data, size))
+      return type->m_create(data, size);
   }
 
   throw reascript_error { "unsupported format" };
 }
 
-Image *Image::fromFile(const char *file)
+void Image::Decoder::setSize(const size_t width, const size_t height,
+  const int format)
 {
-  std::ifstream stream;
-  stream.open(WIDEN(file), std::ios_base::binary);
-  if(!stream.good())
-    throw reascript_error { strerror(errno) };
-  return create(stream);
+  if(format != 4)
+    throw reascript_error { "BUG: unexpected pixel format, missing transform?" };
+  m_width = m_fitWidth = width, m_height = m_fitHeight = height;
 }
 
-Image *Image::fromMemory(const char *data, const int size)
+void Image::Decoder::fitWithin(const size_t maxWidth, const size_t maxHeight)
 {
-  using boost::iostreams::array_source;
-  boost::iostreams::stream<array_source> stream { data, size };
-  return create(stream);
+  size_t width { m_width }, height { m_height };
+  Resample::fit(&width, &height, maxWidth, maxHeight);
+  resizeTo(width, height);
 }
 
-const unsigned char *Bitmap::getPixels(void *object, const float,
-  int *width, int *height)
+void Image::Decoder::resizeTo(const size_t width, const size_t height)
+{
+  if(width == m_fitWidth && height == m_fitHeight)
+    return;
+
+  reduceTo(width, height);
+  m_fitWidth = width, m_fitHeight = height;
+}
+
+void Image::Decoder::decode(std::vector<unsigned char> &pixels,
+  const ProgressFunc &progress)
+{
+  constexpr size_t format { 4 };
+  const size_t rowStride { m_fitWidth * format };
+
+  try {
+    pixels.resize(rowStride * m_fitHeight);
+  }
+  catch(const std::bad_alloc &) {
+    throw reascript_error { "cannot allocate memory" };
+  }
+
+  if(m_width != m_fitWidth || m_height != m_fitHeight) {
+    decodeRows([&](const size_t y, const unsigned char *row) {
+      std::copy(row, row + rowStride, &pixels[y * rowStride]);
+      if(progress)
+        progress(y + 1);
+      return true;
+    });
+    return;
+  }
+
+  std::vector<unsigned char *> scanlines;
+  scanlines.reserve(m_height);
+  for(auto it { pixels.begin() }; it < pixels.end(); it += rowStride)
+    scanlines.push_back(&*it);
+
+  m_progress = progress ? &progress : nullptr;
+  readScanlines(scanlines.data());
+  m_progress = nullptr;
+}
+
+void Image::Decoder::decodeRows(const RowFunc &func)
+{
+  if(m_width == m_fitWidth && m_height == m_fitHeight)
+    return readRows(func);
+
+  Resample::Reducer reducer { m_width, m_height, m_fitWidth, m_fitHeight };
+  size_t y {};
+  readRows([&](size_t, const unsigned char *row) {
+    if(const unsigned char *reduced { reducer.push(row) })
+      return func(y++, reduced);
+    return true;
+  });
+}
+
+void Image::Decoder::readRows(const RowFunc &func)
+{
+  constexpr size_t format { 4 };
+  const size_t rowStride { m_width * format };
+
+  // enough for the rows output at once by any decoder (eg. JPEG's iMCU rows)
+  constexpr size_t RING_ROWS { 64 };
+  const size_t ringRows
+    { readsRowsInOrder() ? std::min(RING_ROWS, m_height) : m_height };
+  std::vector<unsigned char> ring;
+  try {
+    ring.resize(rowStride * ringRows);
+  }
+  catch(const std::bad_alloc &) {
+    throw reascript_error { "cannot allocate memory" };
+  }
+
+  std::vector<unsigned char *> scanlines(m_height);
+  for(size_t y {}; y < m_height; ++y)
+    scanlines[y] = &ring[(y % ringRows) * rowStride];
+
+  // rows are passed on as soon as they are reported, before being reused
+  struct Stop {};
+  size_t done {};
+  const auto flush { [&](const size_t count) {
+    if(count - done > ringRows)
+      throw reascript_error { "BUG: too many rows decoded at once" };
+    for(; done < count; ++done) {
+      if(!func(done, scanlines[done]))
+        throw Stop {};
+    }
+  } };
+  const ProgressFunc progress { flush };
+
+  m_progress = readsRowsInOrder() ? &progress : nullptr;
+  try {
+    readScanlines(scanlines.data());
+    m_progress = nullptr;
+  }
+  catch(const Stop &) {
+    m_progress = nullptr;
+    return;
+  }
+  catch(...) {
+    m_progress = nullptr;
+    throw;
+  }
+
+  try {
+    flush(m_height);
+  }
+  catch(const Stop &) {}
+}
+
+void Image::Decoder::scanlinesRead(const size_t count)
+{
+  if(m_progress)
+    (*m_progress)(count);
+}
+
+// tiled images only keep a downscaled copy of their pixels in memory,
+// returns false if the image fits in a single texture
+static bool fitOverview(size_t *width, size_t *height)
+{
+  if(*width <= MAX_TEXTURE_SIZE && *height <= MAX_TEXTURE_SIZE)
+    return false;
+
+  Resample::fit(width, height, MAX_OVERVIEW_SIZE, MAX_OVERVIEW_SIZE);
+  return true;
+}
+
+Image *Image::fromFile(const char *file, const int flags,
+  const size_t maxWidth, const size_t maxHeight)
+{
+  const bool release { !!(flags & ReaImGuiImageFlags_ReleasePixels) };
+
+  ImageCache &cache { ImageCache::get() };
+  ImageCache::Key key { {}, 0, 0, maxWidth, maxHeight };
+  bool cacheable { ImageCache::Key::fromFile(file, &key) };
+  if(ImageCache::Entry entry; cacheable && cache.find(key, &entry)) {
+    Bitmap *bitmap { new Bitmap { entry } };
+    if(release)
+      bitmap->setSource({ file, {}, maxWidth, maxHeight }, true);
+    return bitmap;
+  }
+
+  auto buffer { std::make_unique<FileBuffer>(file) };
+
+  // only the header is read synchronously
+  std::unique_ptr<Decoder> decoder
+    { createDecoder(buffer->data(), buffer->size()) };
+  decoder->fitWithin(maxWidth, maxHeight);
+
+  // the tiles are decoded again from the file when drawn
+  size_t width { decoder->width() }, height { decoder->height() };
+  const bool tiled { fitOverview(&width, &height) };
+  cacheable &= !tiled;
+
+  Bitmap *bitmap;
+  if(flags & ReaImGuiImageFlags_Async) {
+    bitmap = new Bitmap
+      { std::move(buffer), std::move(decoder), cacheable ? &key : nullptr };
+  }
+  else {
+    bitmap = new Bitmap { *decoder };
+    if(cacheable)
+      cache.insert(key, bitmap->cacheEntry());
+  }
+
+  if(release || tiled)
+    bitmap->setSource({ file, {}, maxWidth, maxHeight }, release);
+
+  return bitmap;
+}
+
+Image *Image::fromMemory(const char *data, const int size, const int flags)
+{
+  if(size < 0)
+    throw reascript_error { "invalid size" };
+
+  const bool release { !!(flags & ReaImGuiImageFlags_ReleasePixels) };
+  const auto bytes { reinterpret_cast<const unsigned char *>(data) };
+  Bitmap *bitmap { new Bitmap { *createDecoder(bytes, size) } };
+  if(release || bitmap->isTiled())
+    bitmap->setSource({ {}, { bytes, bytes + size }, 0, 0 }, release);
+
+  return bitmap;
+}
+
+static std::unique_ptr<Image::Decoder> openSource(const Bitmap::Source &source,
+  const size_t width, const size_t height, std::unique_ptr<FileBuffer> *file)
+{
+  const unsigned char *data { source.data.data() };
+  size_t size { source.data.size() };
+  if(!source.file.empty()) {
+    *file = std::make_unique<FileBuffer>(source.file.c_str());
+    data = (*file)->data(), size = (*file)->size();
+  }
+
+  auto decoder { Image::createDecoder(data, size) };
+  decoder->fitWithin(source.maxWidth, source.maxHeight);
+  if(decoder->width() != width || decoder->height() != height)
+    throw reascript_error { "image size has changed" };
+
+  return decoder;
+}
+
+struct Bitmap::Job {
+  enum State { Pending, Done, Failed };
+
+  void run();
+
+  // when reloading released pixels, the decoder is created by the worker
+  std::shared_ptr<const Source> source;
+  size_t width {}, height {};
+  // the decoder reads directly from the file's contents
+  std::unique_ptr<FileBuffer> file;
+  std::unique_ptr<Decoder> decoder;
+  std::unique_ptr<ImageCache::Key> cacheKey;
+  std::vector<unsigned char> pixels;
+  std::string error;
+  std::atomic<State> state { Pending };
+  // rows of pixels fully decoded from the top
+  std::atomic<size_t> rowsReady {};
+
+  // owned by the main thread: completed rows copied while decoding
+  std::shared_ptr<ImageCache::Pixels> preview;
+  std::chrono::steady_clock::time_point lastPreview;
+};
+
+void Bitmap::Job::run()
+try {
+  if(!decoder) {
+    decoder = openSource(*source, width, height, &file);
+    size_t overviewWidth { width }, overviewHeight { height };
+    if(fitOverview(&overviewWidth, &overviewHeight))
+      decoder->resizeTo(overviewWidth, overviewHeight);
+  }
+  decoder->decode(pixels, [this](const size_t rows) { rowsReady = rows; });
+  decoder.reset(); // free the decompression state and the file
+  file.reset();
+  state = Done;
+}
+catch(const std::exception &e) { // including bad_alloc for huge dimensions
+  error = e.what();
+  state = Failed;
+}
+
+// decodes a row of tiles, discarding the rest of the image
+struct Bitmap::TileJob {
+  struct Piece {
+    size_t index;
+    TileGrid::Tile area; // including the border
+    ImageCache::Pixels pixels;
+  };
+
+  void run();
+
+  std::shared_ptr<const Source> source;
+  size_t width, height;
+  std::vector<Piece> pieces;
+  std::string error;
+  std::atomic<Job::State> state { Job::Pending };
+};
+
+void Bitmap::TileJob::run()
+try {
+  std::unique_ptr<FileBuffer> file;
+  const auto decoder { openSource(*source, width, height, &file) };
+
+  // the pieces are all in the same row of tiles
+  const size_t top    { pieces.front().area.y },
+               bottom { pieces.front().area.bottom() };
+  for(Piece &piece : pieces)
+    piece.pixels.resize(piece.area.width * piece.area.height * 4);
+
+  decoder->decodeRows([&](const size_t y, const unsigned char *row) {
+    if(y < top)
+      return true;
+
+    for(Piece &piece : pieces) {
+      const size_t rowSize { piece.area.width * 4 };
+      const unsigned char *in { row + (piece.area.x * 4) };
+      std::copy(in, in + rowSize, &piece.pixels[(y - top) * rowSize]);
+    }
+
+    return y + 1 < bottom;
+  });
+
+  state = Job::Done;
+}
+catch(const std::exception &e) {
+  error = e.what();
+  state = Job::Failed;
+}
+
+static size_t g_residentBytes, g_releasedBytes;
+
+void Bitmap::memoryUsage(size_t *resident, size_t *released)
+{
+  *resident = g_residentBytes + ImageCache::get().unusedSize();
+  *released = g_releasedBytes;
+}
+
+bool Bitmap::isTiled(size_t width, size_t height)
+{
+  return fitOverview(&width, &height);
+}
+
+Bitmap::Bitmap(Decoder &decoder)
+  : Bitmap { decoder.width(), decoder.height() }
+{
+  size_t width, height;
+  pixelsSize(&width, &height);
+  decoder.resizeTo(width, height);
+
+  auto pixels { std::make_shared<ImageCache::Pixels>() };
+  decoder.decode(*pixels);
+  setPixels(std::move(pixels));
+}
+
+Bitmap::Bitmap(const ImageCache::Entry &entry)
+  : Bitmap { entry.width, entry.height }
+{
+  setPixels(entry.pixels);
+}
+
+Bitmap::Bitmap(std::unique_ptr<FileBuffer> file,
+               std::unique_ptr<Decoder> decoder,
+               const ImageCache::Key *cacheKey)
+  : Bitmap { decoder->width(), decoder->height() }
+{
+  size_t width, height;
+  pixelsSize(&width, &height);
+  decoder->resizeTo(width, height);
+
+  m_job = std::make_shared<Job>();
+  m_job->file    = std::move(file);
+  m_job->decoder = std::move(decoder);
+  if(cacheKey)
+    m_job->cacheKey = std::make_unique<ImageCache::Key>(*cacheKey);
+  startJob();
+}
+
+Bitmap::Bitmap(const size_t width, const size_t height)
+  : m_width { width }, m_height { height }, m_generation {},
+    m_released { false }, m_releasePixels { false }, m_rowsShown {}
+{
+  if(isTiled()) {
+    m_tiles = std::make_unique<TileGrid>(m_width, m_height, MAX_RESIDENT_TILES);
+    m_tileData.resize(m_tiles->count());
+  }
+}
+
+Bitmap::~Bitmap()
+{
+  setPixels(nullptr);
+  for(TileData &tile : m_tileData)
+    setTilePixels(tile, {});
+}
+
+void Bitmap::setSource(Source &&source, const bool releasePixels)
+{
+  m_source = std::make_shared<Source>(std::move(source));
+  m_releasePixels = releasePixels;
+}
+
+void Bitmap::pixelsSize(size_t *width, size_t *height) const
+{
+  *width = m_width, *height = m_height;
+  fitOverview(width, height);
+}
+
+void Bitmap::startJob()
+{
+  m_rowsShown = 0;
+
+  // don't keep the job alive (and decode for nothing) if the image is
+  // destroyed before a worker gets to it
+  ThreadPool::get().push([weakJob = std::weak_ptr<Job> { m_job }] {
+    if(const auto job { weakJob.lock() })
+      job->run();
+  });
+}
+
+void Bitmap::setPixels(std::shared_ptr<const ImageCache::Pixels> pixels)
+{
+  if(m_pixels)
+    g_residentBytes -= m_pixels->size();
+  else if(m_released)
+    g_releasedBytes -= releasedSize();
+
+  const bool dropped { m_pixels != nullptr };
+  m_pixels = std::move(pixels);
+  m_released = false;
+
+  if(m_pixels)
+    g_residentBytes += m_pixels->size();
+
+  // the cache may have been kept over budget by the previous pixels
+  if(dropped)
+    ImageCache::get().evict();
+}
+
+size_t Bitmap::releasedSize() const
+{
+  size_t width, height;
+  pixelsSize(&width, &height);
+  return width * height * 4;
+}
+
+void Bitmap::uploaded(void *object, const float scale)
+{
+  Bitmap *image { static_cast<Bitmap *>(object) };
+
+  // tiles are decoded again from the source if needed
+  if(scale < 0) {
+    image->setTilePixels(image->m_tileData[TileGrid::index(scale)], {});
+    return;
+  }
+
+  // the pixels are only a preview while loading
+  if(!image->m_pixels || !image->m_releasePixels || image->m_job)
+    return;
+
+  // the decoded pixels are kept if still used by other images via the cache
+  std::shared_ptr<const ImageCache::Pixels> pixels { image->m_pixels };
+  image->setPixels(nullptr);
+  ImageCache::get().release(std::move(pixels));
+  image->m_released = true;
+  g_releasedBytes += image->releasedSize();
+}
+
+void Bitmap::reload()
+{
+  const Source &source { *m_source };
+
+  ImageCache::Key key { {}, 0, 0, source.maxWidth, source.maxHeight };
+  const bool cacheable { !isTiled() && !source.file.empty() &&
+    ImageCache::Key::fromFile(source.file.c_str(), &key) };
+  ImageCache::Entry entry;
+  if(cacheable && ImageCache::get().find(key, &entry) &&
+      entry.width == m_width && entry.height == m_height) {
+    setPixels(entry.pixels);
+    return;
+  }
+
+  // decoded in the background as with ImageFlags_Async,
+  // errors are reported by isLoaded
+  m_job = std::make_shared<Job>();
+  m_job->source = m_source;
+  m_job->width  = m_width;
+  m_job->height = m_height;
+  if(cacheable)
+    m_job->cacheKey = std::make_unique<ImageCache::Key>(key);
+  startJob();
+}
+
+void Bitmap::poll()
+{
+  pollTiles();
+
+  if(!m_job)
+    return;
+  else if(m_job->state == Job::Pending)
+    return showProgress();
+
+  if(m_job->state == Job::Done) {
+    size_t width, height;
+    pixelsSize(&width, &height);
+    setPixels(std::make_shared<ImageCache::Pixels>(std::move(m_job->pixels)));
+    // upload the rest of the decoded pixels on next use
+    if(m_rowsShown == 0)
+      ++m_generation; // replaces the 1x1 placeholder
+    else if(m_rowsShown < height) {
+      m_history.add(++m_generation, { 0, static_cast<int>(m_rowsShown),
+        static_cast<int>(width), static_cast<int>(height) });
+    }
+    if(m_job->cacheKey)
+      ImageCache::get().insert(*m_job->cacheKey, cacheEntry());
+    m_job.reset();
+  }
+  else if(m_pixels) { // don't leave a partial image on screen
+    setPixels(nullptr);
+    ++m_generation;
+  }
+}
+
+void Bitmap::showProgress()
+{
+  // The first rows are shown as soon as they are available, then at most
+  // every PROGRESS_INTERVAL to limit the uploads by renderers unable to
+  // update only the new rows.
+  const size_t rows { m_job->rowsReady };
+  const auto now { std::chrono::steady_clock::now() };
+  if(rows <= m_rowsShown ||
+      (m_rowsShown > 0 && now - m_job->lastPreview < PROGRESS_INTERVAL))
+    return;
+
+  size_t width, height;
+  pixelsSize(&width, &height);
+
+  // the rows being decoded must not be read, so they are copied
+  // instead of sharing the buffer of the decoder
+  const bool first { !m_job->preview };
+  if(first) {
+    m_job->preview = std::make_shared<ImageCache::Pixels>(width * height * 4);
+    setPixels(m_job->preview);
+  }
+
+  const size_t rowSize { width * 4 };
+  const unsigned char *decoded { m_job->pixels.data() };
+  std::copy(decoded + (m_rowsShown * rowSize), decoded + (rows * rowSize),
+            m_job->preview->data() + (m_rowsShown * rowSize));
+
+  ++m_generation;
+  if(!first) { // the 1x1 placeholder must be replaced entirely
+    m_history.add(m_generation, { 0, static_cast<int>(m_rowsShown),
+      static_cast<int>(width), static_cast<int>(rows) });
+  }
+  m_rowsShown = rows;
+  m_job->lastPreview = now;
+}
+
+bool Bitmap::changes(void *object, float, const unsigned int since,
+  Texture::Region *region)
 {
   const Bitmap *image { static_cast<Bitmap *>(object) };
-  *width = image->m_width, *height = image->m_height;
-  return image->m_pixels.data();
+  return image->m_history.since(since, region);
 }
 
-void Bitmap::resize(const int width, const int height, const int format)
-try
+bool Bitmap::isLoaded()
 {
-  if(format != 4)
-    throw reascript_error { "BUG: unexpected pixel format, missing transform?" };
-  m_width = width, m_height = height;
-  m_pixels.resize(m_width * m_height * format);
+  poll();
+
+  if(!m_tileError.empty())
+    throw reascript_error { std::exchange(m_tileError, {}) };
+  else if(!m_job)
+    return true;
+  else if(m_job->state == Job::Failed)
+    throw reascript_error { m_job->error };
+
+  return false;
 }
-catch(const std::bad_alloc &)
+
+const unsigned char *Bitmap::getPixels(void *object, const float scale,
+  int *width, int *height)
 {
-  throw reascript_error { "cannot allocate memory" };
+  Bitmap *image { static_cast<Bitmap *>(object) };
+
+  if(scale < 0)
+    return image->getTilePixels(TileGrid::index(scale), width, height);
+
+  if(!image->loadPixels()) {
+    // still loading or failed to load
+    static const unsigned char transparent[4] {};
+    *width = *height = 1;
+    return transparent;
+  }
+
+  size_t pixelsWidth, pixelsHeight;
+  image->pixelsSize(&pixelsWidth, &pixelsHeight);
+  *width = pixelsWidth, *height = pixelsHeight;
+  return image->m_pixels->data();
 }
 
-std::vector<unsigned char *> Bitmap::makeScanlines()
+const unsigned char *Bitmap::loadPixels()
 {
-  std::vector<unsigned char *> scanlines;
-  scanlines.reserve(m_height);
-  const auto rowStride { m_width * 4 };
-  for(auto it { m_pixels.begin() }; it < m_pixels.end(); it += rowStride)
-    scanlines.push_back(&*it);
-  return scanlines;
+  poll();
+
+  // a new renderer needs the pixels after they were released
+  if(m_released && !m_job)
+    reload();
+
+  return m_pixels ? m_pixels->data() : nullptr;
+}
+
+const unsigned char *Bitmap::pixels()
+{
+  // only the overview of tiled images is in memory
+  return isTiled() ? nullptr : loadPixels();
+}
+
+void Bitmap::setTilePixels(TileData &tile, ImageCache::Pixels &&pixels)
+{
+  g_residentBytes -= tile.pixels.size();
+  tile.pixels = std::move(pixels);
+  g_residentBytes += tile.pixels.size();
+}
+
+const unsigned char *Bitmap::getTilePixels(const size_t index,
+  int *width, int *height)
+{
+  TileData &tile { m_tileData[index] };
+  if(tile.pixels.empty()) {
+    // uploaded to another renderer or not decoded yet
+    tile.ready = false;
+    decodeTiles(index);
+
+    static const unsigned char transparent[4] {};
+    *width = *height = 1;
+    return transparent;
+  }
+
+  const TileGrid::Tile area { m_tiles->withBorder(m_tiles->tile(index)) };
+  *width = area.width, *height = area.height;
+  return tile.pixels.data();
+}
+
+void Bitmap::decodeTiles(const size_t index)
+{
+  if(m_tileData[index].loading)
+    return;
+
+  auto job { std::make_shared<TileJob>() };
+  job->source = m_source;
+  job->width  = m_width;
+  job->height = m_height;
+
+  // every tile of the same row about to be drawn is decoded at once
+  // (not only those already requested by the renderer)
+  const size_t columns { m_tiles->columns() },
+               first   { index - (index % columns) };
+  for(size_t i { first }; i < first + columns; ++i) {
+    TileData &tile { m_tileData[i] };
+    if(i == index || (m_tiles->isResident(i) && !tile.ready &&
+                      tile.pixels.empty() && !tile.loading)) {
+      job->pieces.push_back({ i, m_tiles->withBorder(m_tiles->tile(i)), {} });
+      tile.loading = true;
+    }
+  }
+
+  m_tileJobs.push_back(job);
+  ThreadPool::get().push([weakJob = std::weak_ptr<TileJob> { job }] {
+    if(const auto job { weakJob.lock() })
+      job->run();
+  });
+}
+
+void Bitmap::pollTiles()
+{
+  for(auto it { m_tileJobs.begin() }; it != m_tileJobs.end();) {
+    TileJob &job { **it };
+    if(job.state == Job::Pending) {
+      ++it;
+      continue;
+    }
+
+    for(TileJob::Piece &piece : job.pieces) {
+      TileData &tile { m_tileData[piece.index] };
+      tile.loading = false;
+      // evicted while decoding
+      if(job.state != Job::Done || !m_tiles->isResident(piece.index))
+        continue;
+      setTilePixels(tile, std::move(piece.pixels));
+      tile.ready = true;
+      ++tile.generation;
+    }
+
+    if(job.state == Job::Failed)
+      m_tileError = job.error;
+
+    it = m_tileJobs.erase(it);
+  }
+}
+
+bool Bitmap::isTileStale(void *object, const float scale)
+{
+  const Bitmap *image { static_cast<Bitmap *>(object) };
+  return !image->m_tiles->isResident(TileGrid::index(scale));
+}
+
+ImageCache::Entry Bitmap::cacheEntry() const
+{
+  return { m_pixels, m_width, m_height };
+}
+
+void Bitmap::draw(ImDrawList *drawList, TextureManager *textureManager,
+  const ImVec2 &pMin, const ImVec2 &pMax,
+  const ImVec2 &uvMin, const ImVec2 &uvMax, const unsigned int col)
+{
+  const auto inRange { [](const float uv) { return uv >= 0.f && uv <= 1.f; } };
+  if(!isTiled() || !inRange(uvMin.x) || !inRange(uvMin.y) ||
+                   !inRange(uvMax.x) || !inRange(uvMax.y))
+    return Image::draw(drawList, textureManager, pMin, pMax, uvMin, uvMax, col);
+
+  // source area in image pixels, possibly flipped
+  const double srcX1 { uvMin.x * m_width  }, srcX2 { uvMax.x * m_width  },
+               srcY1 { uvMin.y * m_height }, srcY2 { uvMax.y * m_height };
+  if(srcX1 == srcX2 || srcY1 == srcY2)
+    return;
+
+  // use the downscaled copy when zoomed out enough for it to look the same
+  // (and while it is being loaded)
+  size_t overviewWidth, overviewHeight;
+  pixelsSize(&overviewWidth, &overviewHeight);
+  poll();
+  if(m_job ||
+     (std::abs(pMax.x - pMin.x) <= std::abs(srcX2 - srcX1) *
+                                   overviewWidth / m_width &&
+      std::abs(pMax.y - pMin.y) <= std::abs(srcY2 - srcY1) *
+                                   overviewHeight / m_height))
+    return Image::draw(drawList, textureManager, pMin, pMax, uvMin, uvMax, col);
+
+  keepAlive();
+
+  const unsigned int stamp { m_tiles->nextStamp() };
+
+  const auto toScreenX { [&](const double x) -> float {
+    return pMin.x + ((x - srcX1) / (srcX2 - srcX1) * (pMax.x - pMin.x));
+  } };
+  const auto toScreenY { [&](const double y) -> float {
+    return pMin.y + ((y - srcY1) / (srcY2 - srcY1) * (pMax.y - pMin.y));
+  } };
+
+  const ImVec2 &clipMin { drawList->GetClipRectMin() },
+               &clipMax { drawList->GetClipRectMax() };
+  const double left  { std::min(srcX1, srcX2) }, right  { std::max(srcX1, srcX2) },
+               top   { std::min(srcY1, srcY2) }, bottom { std::max(srcY1, srcY2) };
+  constexpr size_t TILE_SIZE { TileGrid::TILE_SIZE };
+  const size_t columns { m_tiles->columns() }, rows { m_tiles->rows() };
+  const size_t firstColumn { static_cast<size_t>(left / TILE_SIZE) },
+               firstRow    { static_cast<size_t>(top  / TILE_SIZE) },
+               lastColumn  { std::min(columns - 1, static_cast<size_t>(right  / TILE_SIZE)) },
+               lastRow     { std::min(rows    - 1, static_cast<size_t>(bottom / TILE_SIZE)) };
+
+  struct Quad { size_t texId; ImVec2 p1, p2, uv1, uv2; };
+  std::vector<Quad> quads;
+  bool ready { true };
+
+  for(size_t row { firstRow }; row <= lastRow; ++row) {
+    for(size_t column { firstColumn }; column <= lastColumn; ++column) {
+      const size_t index { (row * columns) + column };
+      const TileGrid::Tile core { m_tiles->tile(index) };
+      const double x1 { std::max<double>(core.x, left) },
+                   x2 { std::min<double>(core.right(), right) },
+                   y1 { std::max<double>(core.y, top) },
+                   y2 { std::min<double>(core.bottom(), bottom) };
+      if(x1 >= x2 || y1 >= y2)
+        continue;
+
+      const ImVec2 p1 { toScreenX(x1), toScreenY(y1) },
+                   p2 { toScreenX(x2), toScreenY(y2) };
+      if(std::max(p1.x, p2.x) < clipMin.x || std::min(p1.x, p2.x) > clipMax.x ||
+         std::max(p1.y, p2.y) < clipMin.y || std::min(p1.y, p2.y) > clipMax.y)
+        continue; // not visible
+
+      Texture tex { this, TileGrid::key(index), &getPixels };
+      tex.m_isValid = &Resource::isValid;
+      tex.m_isStale = &isTileStale;
+      tex.m_uploaded = &uploaded;
+      tex.generation = m_tileData[index].generation;
+      const size_t texId { textureManager->touch(tex) };
+      m_tiles->use(index, stamp);
+      ready &= m_tileData[index].ready;
+
+      // the tile texture includes a 1 pixel border (see TileGrid::withBorder)
+      const TileGrid::Tile area { m_tiles->withBorder(core) };
+      const auto toUV { [&](const double x, const double y) {
+        return ImVec2((x - area.x) / area.width, (y - area.y) / area.height);
+      } };
+
+      quads.push_back({ texId, p1, p2, toUV(x1, y1), toUV(x2, y2) });
+    }
+  }
+
+  // Least recently drawn first. The textures are removed by
+  // TextureManager::cleanup at the beginning of the next frame.
+  for(const size_t index : m_tiles->evict(stamp)) {
+    TileData &tile { m_tileData[index] };
+    setTilePixels(tile, {});
+    tile.ready = false;
+  }
+
+  // show the overview until every visible tile is decoded
+  if(!ready)
+    return Image::draw(drawList, textureManager, pMin, pMax, uvMin, uvMax, col);
+
+  for(const Quad &quad : quads)
+    drawList->AddImage(quad.texId, quad.p1, quad.p2, quad.uv1, quad.uv2, col);
 }
 
 size_t Bitmap::makeTexture(TextureManager *textureManager)
+{
+  poll();
+  keepAlive();
+  Texture tex { this, 1.f, &getPixels };
+  tex.m_isValid = &Resource::isValid;
+  tex.m_changes = &changes;
+  if(m_releasePixels)
+    tex.m_uploaded = &uploaded;
+  tex.generation = m_generation;
+  return textureManager->touch(tex);
+}
+
+PixelImage::PixelImage(const int width, const int height)
+  : m_width { static_cast<size_t>(width) },
+    m_height { static_cast<size_t>(height) }, m_generation {}
+{
+  if(width < 1 || height < 1)
+    throw reascript_error { "invalid image size" };
+
+  try {
+    m_pixels.resize(m_width * m_height * 4); // transparent
+  }
+  catch(const std::bad_alloc &) {
+    throw reascript_error { "cannot allocate memory" };
+  }
+}
+
+unsigned char *PixelImage::prepareWrite(const int x, const int y,
+  const int w, const int h, const size_t count)
+{
+  if(x < 0 || y < 0 || w < 1 || h < 1 ||
+      static_cast<size_t>(x) + w > m_width ||
+      static_cast<size_t>(y) + h > m_height)
+    throw reascript_error { "rectangle is out of bounds" };
+  else if(count < static_cast<size_t>(w) * h)
+    throw reascript_error { "not enough pixels were provided" };
+
+  m_history.add(++m_generation, { x, y, x + w, y + h });
+
+  return &m_pixels[((y * m_width) + x) * 4];
+}
+
+// converting NaN or out of range values to an integer is undefined behavior
+static uint32_t toRGBA(const double value)
+{
+  if(std::isnan(value))
+    return 0;
+
+  // negative values are accepted as signed 32-bit integers
+  const double clamped { std::clamp<double>(value, INT32_MIN, UINT32_MAX) };
+  return static_cast<uint32_t>(static_cast<int64_t>(clamped));
+}
+
+void PixelImage::write(const int x, const int y, const int w, const int h,
+  const double *values, const size_t count)
+{
+  unsigned char *row { prepareWrite(x, y, w, h, count) };
+  for(int i {}; i < h; ++i, row += m_width * 4) {
+    unsigned char *pixel { row };
+    for(int j {}; j < w; ++j) {
+      const uint32_t rgba { toRGBA(*values++) };
+      *pixel++ = rgba >> 24;
+      *pixel++ = rgba >> 16;
+      *pixel++ = rgba >> 8;
+      *pixel++ = rgba;
+    }
+  }
+}
+
+void PixelImage::write(const int x, const int y, const int w, const int h,
+  const unsigned char *data, const size_t size)
+{
+  const size_t rowSize { static_cast<size_t>(w) * 4 };
+  unsigned char *row { prepareWrite(x, y, w, h, size / 4) };
+  for(int i {}; i < h; ++i, row += m_width * 4, data += rowSize)
+    std::copy(data, data + rowSize, row);
+}
+
+const unsigned char *PixelImage::getPixels(void *object, const float,
+  int *width, int *height)
+{
+  const PixelImage *image { static_cast<PixelImage *>(object) };
+  *width = image->m_width, *height = image->m_height;
+  return image->m_pixels.data();
+}
+
+bool PixelImage::changes(void *object, float, const unsigned int since,
+  Texture::Region *region)
+{
+  const PixelImage *image { static_cast<PixelImage *>(object) };
+  return image->m_history.since(since, region);
+}
+
+size_t PixelImage::makeTexture(TextureManager *textureManager)
 {
   keepAlive();
   Texture tex { this, 1.f, &getPixels };
   tex.m_isValid = &Resource::isValid;
+  tex.m_changes = &changes;
+  tex.generation = m_generation;
   return textureManager->touch(tex);
 }
 
+void Image::draw(ImDrawList *drawList, TextureManager *textureManager,
+  const ImVec2 &pMin, const ImVec2 &pMax,
+  const ImVec2 &uvMin, const ImVec2 &uvMax, const unsigned int col)
+{
+  drawList->AddImage(makeTexture(textureManager), pMin, pMax, uvMin, uvMax, col);
+}
+
 void ImageSet::add(const float scale, Image *img)
 {
   // don't allow infinite recursion
-  if(dynamic_cast<ImageSet *>(img))
+  if(img->as<ImageSet>())
     throw reascript_error { "image cannot be a set" };
 
   auto it { std::lower_bound(m_images.begin(), m_images.end(), scale) };
@@ -118,12 +979,11 @@ void ImageSet::add(const float scale, Image *img)
   m_images.emplace(it, scale, img);
 }
 
-const ImageSet::Item &ImageSet::select() const
+const ImageSet::Item &ImageSet::select(const float scale) const
 {
   if(m_images.empty())
     throw reascript_error { "image set is empty" };
 
-  const float scale { ImGui::GetWindowDpiScale() };
   const auto it { std::lower_bound(m_images.begin(), m_images.end(), scale) };
   if(it == m_images.begin())
     return *it;
@@ -137,22 +997,121 @@ const ImageSet::Item &ImageSet::select() const
     return *it;
 }
 
+ImageSet::Variant *ImageSet::variant(const float scale)
+{
+  const Item &nearest { select(scale) };
+  if(!ImageVariants::isNeeded(nearest.scale, scale))
+    return nullptr;
+
+  // downscale the smallest image larger than needed, upscaling is left to the GPU
+  const auto source
+    { std::lower_bound(m_images.begin(), m_images.end(), scale) };
+  if(source == m_images.end() ||
+      source->image->width()  > MAX_TEXTURE_SIZE ||
+      source->image->height() > MAX_TEXTURE_SIZE) // tiled, not in memory
+    return nullptr;
+
+  const double ratio { scale / source->scale };
+  const size_t width  { static_cast<size_t>(std::round(source->image->width()  * ratio)) },
+               height { static_cast<size_t>(std::round(source->image->height() * ratio)) };
+  if(!width || !height || width > MAX_TEXTURE_SIZE || height > MAX_TEXTURE_SIZE)
+    return nullptr;
+
+  return &m_variants.update(scale, source->image, width, height,
+                            source->image->generation());
+}
+
+const unsigned char *ImageSet::getPixels(void *object, const float scale,
+  int *width, int *height)
+{
+  ImageSet *set { static_cast<ImageSet *>(object) };
+  Variant *variant { set->m_variants.find(scale) };
+  Image *image { variant ? static_cast<Image *>(variant->source) : nullptr };
+  const unsigned char *source { image ? image->pixels() : nullptr };
+  if(!source) {
+    static const unsigned char transparent[4] {};
+    *width = *height = 1;
+    return transparent;
+  }
+
+  // generated on demand, as the pixels are freed when memory is tight
+  if(variant->pixels.empty()) {
+    Resample::downscale(source, image->width(), image->height(),
+      set->m_variants.allocate(*variant).data(), variant->width, variant->height);
+  }
+
+  *width = variant->width, *height = variant->height;
+  return variant->pixels.data();
+}
+
+void ImageSet::uploaded(void *object, const float scale)
+{
+  static_cast<ImageSet *>(object)->m_variants.uploaded(scale);
+}
+
+bool ImageSet::removeVariant(void *object, const float scale)
+{
+  // unused for a while (eg. the window moved to another monitor)
+  static_cast<ImageSet *>(object)->m_variants.remove(scale);
+  return true;
+}
+
+ImageSet::ImageSet()
+{
+  enableHeartbeat(); // to keep the images alive
+}
+
 size_t ImageSet::width() const
 {
-  const Item &item { select() };
+  const Item &item { select(ImGui::GetWindowDpiScale()) };
   return item.image->width() / item.scale;
 }
 
 size_t ImageSet::height() const
 {
-  const Item &item { select() };
+  const Item &item { select(ImGui::GetWindowDpiScale()) };
   return item.image->height() / item.scale;
 }
 
+bool ImageSet::isLoaded()
+{
+  bool loaded { true };
+  for(const auto &item : m_images)
+    loaded &= item.image->isLoaded();
+  return loaded;
+}
+
+size_t ImageSet::makeTexture(TextureManager *textureManager, Variant &variant)
+{
+  Texture tex { this, variant.scale, &getPixels };
+  tex.m_isValid = &Resource::isValid;
+  tex.m_uploaded = &uploaded;
+  tex.m_compact = &removeVariant;
+  tex.generation = variant.generation;
+  return textureManager->touch(tex);
+}
+
 size_t ImageSet::makeTexture(TextureManager *textureManager)
 {
   keepAlive();
-  return select().image->makeTexture(textureManager);
+  const float scale { ImGui::GetWindowDpiScale() };
+  if(Variant *variant { this->variant(scale) })
+    return makeTexture(textureManager, *variant);
+  return select(scale).image->makeTexture(textureManager);
+}
+
+void ImageSet::draw(ImDrawList *drawList, TextureManager *textureManager,
+  const ImVec2 &pMin, const ImVec2 &pMax,
+  const ImVec2 &uvMin, const ImVec2 &uvMax, const unsigned int col)
+{
+  keepAlive();
+  const float scale { ImGui::GetWindowDpiScale() };
+  if(Variant *variant { this->variant(scale) }) {
+    drawList->AddImage(makeTexture(textureManager, *variant),
+      pMin, pMax, uvMin, uvMax, col);
+  }
+  else
+    select(scale).image->draw(drawList, textureManager, pMin, pMax, uvMin, uvMax, col);
 }
 
 bool ImageSet::heartbeat()
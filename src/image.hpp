@@ -18,20 +18,82 @@
 #ifndef REAIMGUI_IMAGE_HPP
 #define REAIMGUI_IMAGE_HPP
 
+#include "image_cache.hpp"
+#include "image_variants.hpp"
 #include "resource.hpp"
+#include "texture.hpp"
 
+#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
-#include <istream>
 
-class TextureManager;
+class FileBuffer;
+class TileGrid;
+struct ImDrawList;
+struct ImVec2;
 
-class Image : public Resource {
+enum ImageFlags {
+  ReaImGuiImageFlags_None  = 0,
+  ReaImGuiImageFlags_Async = 1<<0,
+  ReaImGuiImageFlags_ReleasePixels = 1<<1,
+};
+
+class Image
+  : public TypedResource<Image, Resource, ResourceSubclass_Image> {
 public:
   static constexpr const char *api_type_name { "ImGui_Image" };
 
+  class Decoder {
+  public:
+    virtual ~Decoder() = default;
+
+    // size of the decoded pixels
+    size_t width()  const { return m_fitWidth;  }
+    size_t height() const { return m_fitHeight; }
+    // downscale to fit within the given size (0 = unlimited)
+    void fitWithin(size_t maxWidth, size_t maxHeight);
+    // downscale to the given size, which must not be larger than the current
+    void resizeTo(size_t width, size_t height);
+    // receives the number of rows complete from the top as decoding
+    // progresses
+    using ProgressFunc = std::function<void (size_t rows)>;
+    void decode(std::vector<unsigned char> &pixels,
+                const ProgressFunc &progress = nullptr);
+    // Receives each row from the top without the whole image being kept in
+    // memory (except for formats unable to produce rows in order, such as
+    // interlaced PNG). Returning false stops decoding, after which the
+    // decoder cannot be used anymore.
+    using RowFunc = std::function<bool (size_t y, const unsigned char *row)>;
+    void decodeRows(const RowFunc &);
+
+  protected:
+    void setSize(size_t width, size_t height, int format);
+    // size of the pixels expected from readScanlines
+    size_t scanlineWidth() const { return m_width;  }
+    size_t scanlineCount() const { return m_height; }
+    // decoders able to cheaply produce a smaller image should do so as long
+    // as it remains at least as large as the given size (calling setSize)
+    virtual void reduceTo(size_t width, size_t height) {}
+    // whether each row is complete once reported to scanlinesRead
+    virtual bool readsRowsInOrder() const { return true; }
+    virtual void readScanlines(unsigned char **) = 0;
+    // to be called by readScanlines after writing rows in order
+    void scanlinesRead(size_t count);
+
+  private:
+    void readRows(const RowFunc &);
+
+    size_t m_width, m_height;       // size produced by readScanlines
+    size_t m_fitWidth, m_fitHeight; // final size after resampling
+    const ProgressFunc *m_progress {};
+  };
+
   struct RegisterType {
-    using TestFunc   = bool   (*)(std::istream &);
-    using CreateFunc = Image *(*)(std::istream &);
+    // the data must remain valid for the lifetime of the decoder
+    using TestFunc   = bool (*)(const unsigned char *data, size_t size);
+    using CreateFunc = std::unique_ptr<Decoder> (*)(const unsigned char *data,
+                                                    size_t size);
 
     RegisterType(TestFunc, CreateFunc);
 
@@ -40,47 +102,165 @@ public:
     const RegisterType * const m_next;
   };
 
-  static Image *fromFile(const char *);
-  static Image *fromMemory(const char *, int size);
+  static std::unique_ptr<Decoder> createDecoder(const unsigned char *data,
+                                                size_t size);
+  static Image *fromFile(const char *, int flags = ReaImGuiImageFlags_None,
+                         size_t maxWidth = 0, size_t maxHeight = 0);
+  static Image *fromMemory(const char *, int size,
+                           int flags = ReaImGuiImageFlags_None);
 
   virtual size_t width()  const = 0;
   virtual size_t height() const = 0;
+  virtual bool isLoaded() { return true; }
   virtual size_t makeTexture(TextureManager *) = 0;
+  // width() x height() RGBA pixels or nullptr if unavailable (eg. loading)
+  virtual const unsigned char *pixels() { return nullptr; }
+  // incremented whenever the pixels change
+  virtual unsigned int generation() const { return 0; }
+  // draw the uvMin-uvMax area of the image into the pMin-pMax rectangle
+  virtual void draw(ImDrawList *, TextureManager *,
+                    const ImVec2 &pMin,  const ImVec2 &pMax,
+                    const ImVec2 &uvMin, const ImVec2 &uvMax, unsigned int col);
 
   bool attachable(const Context *) const override { return true; }
 };
 
 using ImGui_Image = Image;
 
-class Bitmap : public Image {
+class Bitmap
+  : public TypedResource<Bitmap, Image, ImageSubclass_Bitmap> {
 public:
+  // where to decode the pixels again from after releasing them
+  struct Source {
+    std::string file;
+    std::vector<unsigned char> data;
+    size_t maxWidth, maxHeight;
+  };
+
+  static void memoryUsage(size_t *resident, size_t *released);
+  // images too large for a single texture are drawn in tiles
+  static bool isTiled(size_t width, size_t height);
+
+  Bitmap(Decoder &);
+  Bitmap(const ImageCache::Entry &);
+  // decodes the pixels in the background, then stores them in the cache
+  Bitmap(std::unique_ptr<FileBuffer>, std::unique_ptr<Decoder>,
+         const ImageCache::Key *);
+  ~Bitmap();
+
   size_t width()  const override { return m_width;  }
   size_t height() const override { return m_height; }
+  bool isLoaded() override;
   size_t makeTexture(TextureManager *) override;
+  // nullptr for tiled images, whose full pixels are never in memory
+  const unsigned char *pixels() override;
+  unsigned int generation() const override { return m_generation; }
+  void draw(ImDrawList *, TextureManager *,
+            const ImVec2 &pMin,  const ImVec2 &pMax,
+            const ImVec2 &uvMin, const ImVec2 &uvMax, unsigned int col) override;
+  ImageCache::Entry cacheEntry() const;
+  bool isTiled() const { return isTiled(m_width, m_height); }
+  // the tiles of tiled images are decoded again from the source when drawn,
+  // releasePixels also frees the pixels once uploaded to every renderer
+  void setSource(Source &&, bool releasePixels);
 
-protected:
-  Bitmap() = default;
+private:
+  struct Job;
+  struct TileJob;
+  struct TileData {
+    ImageCache::Pixels pixels; // until uploaded
+    unsigned int generation {};
+    bool loading {}, ready {};
+  };
+
+  Bitmap(size_t width, size_t height);
+
+  static const unsigned char *getPixels(void *object, float scale,
+    int *width, int *height);
+  static void uploaded(void *object, float scale);
+  void startJob();
+  void poll();
+  void showProgress();
+  static bool changes(void *object, float scale, unsigned int since,
+                      Texture::Region *);
+  void setPixels(std::shared_ptr<const ImageCache::Pixels>);
+  // size of m_pixels, downscaled for tiled images
+  void pixelsSize(size_t *width, size_t *height) const;
+  size_t releasedSize() const;
+  const unsigned char *loadPixels();
+  void reload();
+
+  const unsigned char *getTilePixels(size_t index, int *width, int *height);
+  void setTilePixels(TileData &, ImageCache::Pixels &&);
+  void decodeTiles(size_t index);
+  void pollTiles();
+  static bool isTileStale(void *object, float scale);
+
+  std::shared_ptr<const ImageCache::Pixels> m_pixels;
+  size_t m_width, m_height;
+  unsigned int m_generation;
+  bool m_released, m_releasePixels;
+  std::shared_ptr<const Source> m_source;
+  std::shared_ptr<Job> m_job;
+  size_t m_rowsShown; // while loading
+  ChangeHistory m_history;
+
+  std::unique_ptr<TileGrid> m_tiles;
+  std::vector<TileData> m_tileData;
+  std::vector<std::shared_ptr<TileJob>> m_tileJobs;
+  std::string m_tileError;
+};
+
+// Image whose pixels are written directly by the script
+class PixelImage final
+  : public TypedResource<PixelImage, Image, ImageSubclass_PixelImage> {
+public:
+  static constexpr const char *api_type_name { "ImGui_PixelImage" };
 
-  void resize(int width, int height, int format);
-  std::vector<unsigned char *> makeScanlines();
+  PixelImage(int width, int height);
+
+  size_t width()  const override { return m_width;  }
+  size_t height() const override { return m_height; }
+  size_t makeTexture(TextureManager *) override;
+  const unsigned char *pixels() override { return m_pixels.data(); }
+  unsigned int generation() const override { return m_generation; }
+
+  // values are 0xRRGGBBAA
+  void write(int x, int y, int w, int h, const double *values, size_t count);
+  // rows of tightly packed RGBA bytes
+  void write(int x, int y, int w, int h, const unsigned char *data, size_t size);
 
 private:
   static const unsigned char *getPixels(void *object, float scale,
     int *width, int *height);
+  static bool changes(void *object, float scale, unsigned int since,
+                      Texture::Region *);
+  unsigned char *prepareWrite(int x, int y, int w, int h, size_t count);
 
   std::vector<unsigned char> m_pixels;
   size_t m_width, m_height;
+  unsigned int m_generation;
+  ChangeHistory m_history;
 };
 
-class ImageSet final : public Image {
+using ImGui_PixelImage = PixelImage;
+
+class ImageSet final
+  : public TypedResource<ImageSet, Image, ImageSubclass_ImageSet> {
 public:
   static constexpr const char *api_type_name { "ImGui_ImageSet" };
 
+  ImageSet();
+
   void add(float scale, Image *);
 
   size_t width() const override;
   size_t height() const override;
+  bool isLoaded() override;
   size_t makeTexture(TextureManager *) override;
+  void draw(ImDrawList *, TextureManager *,
+            const ImVec2 &pMin,  const ImVec2 &pMax,
+            const ImVec2 &uvMin, const ImVec2 &uvMax, unsigned int col) override;
 
 protected:
   bool heartbeat() override;
@@ -93,11 +273,19 @@ private:
     bool operator<(float targetScale) const { return scale < targetScale; }
   };
 
+  using Variant = ImageVariants::Variant;
+
   static const unsigned char *getPixels(void *object, float scale,
     int *width, int *height);
-  const Item &select() const;
+  static void uploaded(void *object, float scale);
+  static bool removeVariant(void *object, float scale);
+  const Item &select(float scale) const;
+  // downscaled copy of a larger image for a scale missing from the set
+  Variant *variant(float scale);
+  size_t makeTexture(TextureManager *, Variant &);
 
   std::vector<Item> m_images;
+  ImageVariants m_variants;
 };
 
 using ImGui_ImageSet = ImageSet;
@@ -0,0 +1,160 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "image_cache.hpp"
+
+#include "win32_unicode.hpp"
+
+#include <algorithm>
+#include <functional>
+
+#ifndef _WIN32
+#  include <climits>
+#  include <cstdlib>
+#  include <sys/stat.h>
+#endif
+
+constexpr size_t DEFAULT_BUDGET { 128 << 20 };
+
+ImageCache &ImageCache::get()
+{
+  static ImageCache cache { DEFAULT_BUDGET };
+  return cache;
+}
+
+bool ImageCache::Key::fromFile(const char *path, Key *key)
+{
+#ifdef _WIN32
+  wchar_t fullPath[MAX_PATH];
+  const DWORD length
+    { GetFullPathNameW(WIDEN(path), std::size(fullPath), fullPath, nullptr) };
+  if(!length || length >= std::size(fullPath))
+    return false;
+  CharLowerW(fullPath); // case-insensitive file system
+
+  WIN32_FILE_ATTRIBUTE_DATA info;
+  if(!GetFileAttributesExW(fullPath, GetFileExInfoStandard, &info))
+    return false;
+
+  key->path = narrow(fullPath);
+  key->size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) |
+              info.nFileSizeLow;
+  key->modified = (static_cast<int64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) |
+                  info.ftLastWriteTime.dwLowDateTime;
+#else
+  char fullPath[PATH_MAX];
+  struct stat info;
+  if(!realpath(path, fullPath) || stat(fullPath, &info))
+    return false;
+
+  key->path = fullPath;
+  key->size = info.st_size;
+#  ifdef __APPLE__
+  const timespec &mtime { info.st_mtimespec };
+#  else
+  const timespec &mtime { info.st_mtim };
+#  endif
+  key->modified = (static_cast<int64_t>(mtime.tv_sec) * 1'000'000'000) +
+                  mtime.tv_nsec;
+#endif
+
+  return true;
+}
+
+bool ImageCache::Key::operator==(const Key &o) const
+{
+  return size == o.size && modified == o.modified &&
+         maxWidth == o.maxWidth && maxHeight == o.maxHeight && path == o.path;
+}
+
+size_t ImageCache::KeyHash::operator()(const Key &key) const
+{
+  size_t hash { std::hash<std::string>{}(key.path) };
+  for(const size_t value : { static_cast<size_t>(key.size),
+      static_cast<size_t>(key.modified), key.maxWidth, key.maxHeight })
+    hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  return hash;
+}
+
+ImageCache::ImageCache(const size_t budget)
+  : m_budget { budget }, m_size {}
+{
+}
+
+bool ImageCache::find(const Key &key, Entry *entry)
+{
+  const auto it { m_index.find(key) };
+  if(it == m_index.end())
+    return false;
+
+  m_lru.splice(m_lru.begin(), m_lru, it->second);
+  *entry = it->second->second;
+  return true;
+}
+
+void ImageCache::insert(const Key &key, Entry entry)
+{
+  const auto it { m_index.find(key) };
+  if(it != m_index.end()) {
+    m_size -= it->second->second.pixels->size();
+    m_lru.erase(it->second);
+    m_index.erase(it);
+  }
+
+  m_size += entry.pixels->size();
+  m_lru.emplace_front(key, std::move(entry));
+  m_index.emplace(key, m_lru.begin());
+
+  evict();
+}
+
+void ImageCache::evict()
+{
+  // pixels still used by an image would not be freed by evicting them
+  for(auto it { m_lru.end() }; m_size > m_budget && it != m_lru.begin();) {
+    --it;
+    if(it->second.pixels.use_count() > 1)
+      continue;
+
+    m_size -= it->second.pixels->size();
+    m_index.erase(it->first);
+    it = m_lru.erase(it);
+  }
+}
+
+void ImageCache::release(std::shared_ptr<const Pixels> pixels)
+{
+  const auto it { std::find_if(m_lru.begin(), m_lru.end(),
+    [&pixels](const Item &item) { return item.second.pixels == pixels; }) };
+  pixels.reset();
+  if(it == m_lru.end() || it->second.pixels.use_count() > 1)
+    return;
+
+  m_size -= it->second.pixels->size();
+  m_index.erase(it->first);
+  m_lru.erase(it);
+}
+
+size_t ImageCache::unusedSize() const
+{
+  size_t size {};
+  for(const Item &item : m_lru) {
+    if(item.second.pixels.use_count() == 1)
+      size += item.second.pixels->size();
+  }
+  return size;
+}
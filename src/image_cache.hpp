@@ -0,0 +1,79 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAIMGUI_IMAGE_CACHE_HPP
+#define REAIMGUI_IMAGE_CACHE_HPP
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Process-wide store of decoded pixels shared by all images loaded from the
+// same file. Unused entries are kept around until the byte budget is
+// exceeded, least recently used first (on insertion or when an image releases
+// its pixels). Not thread-safe.
+class ImageCache {
+public:
+  using Pixels = std::vector<unsigned char>;
+
+  struct Key {
+    // returns false if the file cannot be identified (eg. does not exist)
+    static bool fromFile(const char *path, Key *);
+
+    bool operator==(const Key &) const;
+
+    std::string path; // canonical
+    uint64_t size;
+    int64_t modified;
+    size_t maxWidth, maxHeight;
+  };
+
+  struct Entry {
+    std::shared_ptr<const Pixels> pixels;
+    size_t width, height;
+  };
+
+  static ImageCache &get();
+
+  ImageCache(size_t budget);
+  ImageCache(const ImageCache &) = delete;
+
+  bool find(const Key &, Entry *);
+  void insert(const Key &, Entry);
+  // to be called when an image stops using its pixels
+  void evict();
+  // drop the entry holding these pixels (regardless of the budget)
+  // unless they are still used by another image
+  void release(std::shared_ptr<const Pixels>);
+  size_t size() const { return m_size; }
+  // bytes held only by the cache
+  size_t unusedSize() const;
+
+private:
+  struct KeyHash { size_t operator()(const Key &) const; };
+  using Item = std::pair<Key, Entry>;
+
+  const size_t m_budget;
+  size_t m_size;
+  std::list<Item> m_lru; // most recently used first
+  std::unordered_map<Key, std::list<Item>::iterator, KeyHash> m_index;
+};
+
+#endif
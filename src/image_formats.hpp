@@ -0,0 +1,70 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAIMGUI_IMAGE_FORMATS_HPP
+#define REAIMGUI_IMAGE_FORMATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Layout of the uncompressed formats, shared by the decoders and by
+// tools/imagetool which encodes them.
+
+// https://qoiformat.org/qoi-specification.pdf
+namespace QOI {
+  constexpr unsigned char MAGIC[] { 'q', 'o', 'i', 'f' };
+  constexpr size_t HEADER_SIZE { 14 }; // magic, width, height, channels, colorspace
+  constexpr unsigned char END_MARKER[] { 0, 0, 0, 0, 0, 0, 0, 1 };
+  constexpr size_t MAX_PIXELS { 400'000'000 };
+
+  enum Op : unsigned char {
+    OP_INDEX = 0x00, // 00xxxxxx
+    OP_DIFF  = 0x40, // 01xxxxxx
+    OP_LUMA  = 0x80, // 10xxxxxx
+    OP_RUN   = 0xc0, // 11xxxxxx
+    OP_RGB   = 0xfe,
+    OP_RGBA  = 0xff,
+    OP_MASK  = 0xc0,
+  };
+
+  inline unsigned int hash(const unsigned char *rgba)
+  {
+    return (rgba[0] * 3 + rgba[1] * 5 + rgba[2] * 7 + rgba[3] * 11) % 64;
+  }
+}
+
+// "RGBA with header": magic, big-endian 32-bit width and height,
+// followed by rows of non-premultiplied RGBA pixels
+namespace RawRGBA {
+  constexpr unsigned char MAGIC[] { 'r', 'g', 'b', 'a', '\r', '\n', 0x1a, '\n' };
+  constexpr size_t HEADER_SIZE { sizeof(MAGIC) + 8 };
+}
+
+inline uint32_t readBigEndian32(const unsigned char *bytes)
+{
+  // promoted to uint32_t first: shifting into the sign bit of an int is UB
+  return (uint32_t { bytes[0] } << 24) | (uint32_t { bytes[1] } << 16) |
+         (uint32_t { bytes[2] } << 8)  |  uint32_t { bytes[3] };
+}
+
+inline void writeBigEndian32(unsigned char *bytes, const uint32_t value)
+{
+  bytes[0] = value >> 24, bytes[1] = value >> 16;
+  bytes[2] = value >> 8,  bytes[3] = value;
+}
+
+#endif
@@ -0,0 +1,107 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "image_variants.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+ImageVariants::Budget &ImageVariants::budget()
+{
+  static Budget budget { 32 << 20 };
+  return budget;
+}
+
+bool ImageVariants::isNeeded(const float nearestScale, const float scale)
+{
+  return std::abs(nearestScale - scale) > nearestScale * TOLERANCE;
+}
+
+ImageVariants::ImageVariants(Budget &budget)
+  : m_budget { budget }
+{
+}
+
+ImageVariants::~ImageVariants()
+{
+  for(Variant &variant : m_variants)
+    freePixels(variant);
+}
+
+ImageVariants::Variant *ImageVariants::find(const float scale)
+{
+  const auto it { std::find_if(m_variants.begin(), m_variants.end(),
+    [scale](const Variant &variant) { return variant.scale == scale; }) };
+  return it != m_variants.end() ? &*it : nullptr;
+}
+
+ImageVariants::Variant &ImageVariants::update(const float scale,
+  void *source, const size_t width, const size_t height,
+  const unsigned int sourceGeneration)
+{
+  Variant *variant { find(scale) };
+  if(!variant)
+    variant = &m_variants.emplace_back(Variant { scale, nullptr, 0, 0, 0, 0, {} });
+
+  if(variant->source != source || variant->width != width ||
+      variant->height != height || variant->sourceGeneration != sourceGeneration) {
+    freePixels(*variant);
+    variant->source = source;
+    variant->width = width, variant->height = height;
+    variant->sourceGeneration = sourceGeneration;
+    ++variant->generation;
+  }
+
+  return *variant;
+}
+
+ImageVariants::Pixels &ImageVariants::allocate(Variant &variant)
+{
+  freePixels(variant);
+  variant.pixels.resize(variant.width * variant.height * 4);
+  m_budget.m_size += variant.pixels.size();
+  return variant.pixels;
+}
+
+bool ImageVariants::uploaded(const float scale)
+{
+  // the pixels can be generated again if another renderer needs them
+  if(!m_budget.exceeded())
+    return false;
+
+  Variant *variant { find(scale) };
+  if(!variant || variant->pixels.empty())
+    return false;
+
+  freePixels(*variant);
+  return true;
+}
+
+void ImageVariants::remove(const float scale)
+{
+  if(Variant *variant { find(scale) }) {
+    freePixels(*variant);
+    m_variants.erase(m_variants.begin() + (variant - m_variants.data()));
+  }
+}
+
+void ImageVariants::freePixels(Variant &variant)
+{
+  m_budget.m_size -= variant.pixels.size();
+  variant.pixels.clear();
+  variant.pixels.shrink_to_fit();
+}
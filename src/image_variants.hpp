@@ -0,0 +1,82 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAIMGUI_IMAGE_VARIANTS_HPP
+#define REAIMGUI_IMAGE_VARIANTS_HPP
+
+#include <cstddef>
+#include <vector>
+
+// Downscaled copies generated by an image set for the scales it lacks.
+// The pixels are generated on demand and freed after upload while the
+// variants of every set exceed their shared memory budget.
+class ImageVariants {
+public:
+  using Pixels = std::vector<unsigned char>;
+
+  // no variant is needed when an image of the set is within 5% of the scale
+  static constexpr float TOLERANCE { 0.05f };
+
+  struct Variant {
+    float scale;
+    void *source; // Image
+    size_t width, height;
+    unsigned int sourceGeneration, generation;
+    Pixels pixels;
+  };
+
+  class Budget {
+  public:
+    Budget(size_t maxBytes) : m_maxBytes { maxBytes }, m_size {} {}
+    Budget(const Budget &) = delete;
+
+    size_t size() const { return m_size; }
+    bool exceeded() const { return m_size > m_maxBytes; }
+
+  private:
+    friend ImageVariants;
+    const size_t m_maxBytes;
+    size_t m_size;
+  };
+
+  // process-wide budget of 32 MiB
+  static Budget &budget();
+  static bool isNeeded(float nearestScale, float scale);
+
+  ImageVariants(Budget & = budget());
+  ImageVariants(const ImageVariants &) = delete;
+  ~ImageVariants();
+
+  Variant *find(float scale);
+  // the pixels are freed if the source, its generation or the size changed
+  Variant &update(float scale, void *source, size_t width, size_t height,
+                  unsigned int sourceGeneration);
+  // storage for the pixels of a variant to be generated
+  Pixels &allocate(Variant &);
+  // returns whether the pixels were freed
+  bool uploaded(float scale);
+  void remove(float scale);
+  size_t count() const { return m_variants.size(); }
+
+private:
+  void freePixels(Variant &);
+
+  Budget &m_budget;
+  std::vector<Variant> m_variants;
+};
+
+#endif
@@ -19,7 +19,7 @@
 
 #include "error.hpp"
 
-#include <array>
+#include <climits> // ULONG_MAX
 #include <cstring> // memcmp
 
 // https://github.com/libjpeg-turbo/libjpeg-turbo/raw/main/example.txt
@@ -27,26 +27,12 @@
 #include <jpeglib.h>
 #include <jerror.h>
 
-class JPEGImage final : public Bitmap {
-public:
-  JPEGImage(std::istream &);
-};
-
-static bool isJPEG(std::istream &stream)
+static bool isJPEG(const unsigned char *data, const size_t size)
 {
   constexpr const unsigned char jpeg[] { 0xFF, 0xD8, 0xFF };
-  char magic[sizeof(jpeg)];
-  stream.read(magic, sizeof(jpeg));
-  return memcmp(jpeg, magic, sizeof(jpeg)) == 0;
+  return size >= sizeof(jpeg) && memcmp(jpeg, data, sizeof(jpeg)) == 0;
 }
 
-static Image *create(std::istream &stream)
-{
-  return new JPEGImage(stream);
-}
-
-static const Image::RegisterType JPEG { &isJPEG, &create };
-
 static void error(j_common_ptr jpeg)
 {
   char message[JMSG_LENGTH_MAX];
@@ -54,89 +40,85 @@ static void error(j_common_ptr jpeg)
   throw reascript_error { message };
 }
 
-struct StreamSource : public jpeg_source_mgr {
-  StreamSource(std::istream &stream)
-    : jpeg_source_mgr {
-        nullptr, 0, init, fill, skip, jpeg_resync_to_restart, term,
-      }, stream { stream }
-  {
-  }
+class JPEGDecoder final : public Image::Decoder {
+public:
+  JPEGDecoder(const unsigned char *data, size_t size);
+
+protected:
+  void reduceTo(size_t width, size_t height) override;
+  void readScanlines(unsigned char **) override;
 
-  std::istream &stream;
-  std::array<char, 4096> buffer;
+private:
+  jpeg_error_mgr m_err;
 
-  static void init(j_decompress_ptr jpeg);
-  static void term(j_decompress_ptr jpeg) {}
-  static boolean fill(j_decompress_ptr jpeg);
-  static void skip(j_decompress_ptr jpeg, long bytes);
+  struct JPEG {
+    ~JPEG() { jpeg_destroy_decompress(&info); }
+    operator jpeg_decompress_struct *() { return &info; }
+    jpeg_decompress_struct *operator->() { return &info; }
+    jpeg_decompress_struct info;
+  } m_jpeg;
 };
 
-void StreamSource::init(j_decompress_ptr jpeg)
+static std::unique_ptr<Image::Decoder> create(const unsigned char *data,
+  const size_t size)
 {
-  StreamSource *src { static_cast<StreamSource *>(jpeg->src) };
-  src->stream.seekg(0); // un-read the magic number bytes
+  return std::make_unique<JPEGDecoder>(data, size);
 }
 
-boolean StreamSource::fill(j_decompress_ptr jpeg)
+static const Image::RegisterType JPEG { &isJPEG, &create };
+
+JPEGDecoder::JPEGDecoder(const unsigned char *data, const size_t size)
 {
-  StreamSource *src { static_cast<StreamSource *>(jpeg->src) };
-  if(!src->stream)
-    ERREXIT(jpeg, JERR_INPUT_EOF);
-  src->stream.read(src->buffer.data(), src->buffer.size());
-  src->next_input_byte = reinterpret_cast<unsigned char *>(src->buffer.data());
-  src->bytes_in_buffer = src->stream.gcount();
-  return TRUE;
+  // jpeg_mem_src takes an unsigned long (32-bit on Windows)
+  if(size > ULONG_MAX)
+    throw reascript_error { "JPEG data is too large" };
+
+  m_jpeg->err = jpeg_std_error(&m_err);
+  m_err.error_exit = error;
+  m_err.output_message = error; // warnings as errors
+
+  jpeg_create_decompress(m_jpeg);
+  jpeg_mem_src(m_jpeg, data, size); // no copy, reads the data in place
+  jpeg_read_header(m_jpeg, TRUE);
+  m_jpeg->out_color_space = JCS_EXT_RGBA; // TODO: save memory with RGB textures
+
+  // jpeg_start_decompress would already decode all of a progressive image
+  jpeg_calc_output_dimensions(m_jpeg);
+  setSize(m_jpeg->output_width, m_jpeg->output_height,
+          m_jpeg->output_components);
 }
 
-void StreamSource::skip(j_decompress_ptr jpeg, long bytes)
+void JPEGDecoder::reduceTo(const size_t width, const size_t height)
 {
-  if(bytes <= 0)
-    return; // no-op as per libjpeg's recommendation
-
-  unsigned int skips {};
-  StreamSource *src { static_cast<StreamSource *>(jpeg->src) };
-  while(bytes > static_cast<long>(src->bytes_in_buffer)) {
-    bytes -= src->bytes_in_buffer;
-    src->bytes_in_buffer = src->buffer.size();
-    ++skips;
-  }
-  if(skips > 0) {
-    src->stream.seekg((skips - 1) * src->buffer.size(), std::ios::cur);
-    fill(jpeg);
-  }
-  src->next_input_byte += bytes;
-  src->bytes_in_buffer -= bytes;
+  // let the IDCT output 1/2, 1/4 or 1/8 of the pixels directly
+  // instead of decoding everything at full size and throwing most of it away
+  const size_t srcWidth { m_jpeg->output_width },
+              srcHeight { m_jpeg->output_height };
+  unsigned int denom { 1 };
+  while(denom < 8 && (srcWidth  / (denom * 2)) >= width &&
+                     (srcHeight / (denom * 2)) >= height)
+    denom *= 2;
+
+  if(denom == 1)
+    return;
+
+  m_jpeg->scale_num   = 1;
+  m_jpeg->scale_denom = denom;
+  jpeg_calc_output_dimensions(m_jpeg);
+  setSize(m_jpeg->output_width, m_jpeg->output_height,
+          m_jpeg->output_components);
 }
 
-JPEGImage::JPEGImage(std::istream &stream)
+void JPEGDecoder::readScanlines(unsigned char **scanlines)
 {
-  struct JPEG {
-    ~JPEG() { jpeg_destroy_decompress(&info); }
-    operator jpeg_decompress_struct *() { return &info; }
-    jpeg_decompress_struct *operator->() { return &info; }
-    jpeg_decompress_struct info;
-  } jpeg;
-
-  jpeg_error_mgr err;
-  jpeg->err = jpeg_std_error(&err);
-  err.error_exit = error;
-  err.output_message = error; // warnings as errors
-
-  jpeg_create_decompress(jpeg);
-  StreamSource src { stream };
-  jpeg->src = &src;
-  jpeg_read_header(jpeg, TRUE);
-  jpeg->out_color_space = JCS_EXT_RGBA; // TODO: save memory with RGB textures
-  jpeg_start_decompress(jpeg);
-
-  resize(jpeg->output_width, jpeg->output_height, jpeg->output_components);
-  std::vector<unsigned char *> scanlines { makeScanlines() };
+  jpeg_start_decompress(m_jpeg);
 
   // jpeg_read_scanlines does not decompress the entire image at once
-  while(jpeg->output_scanline < jpeg->output_height) {
-    jpeg_read_scanlines(jpeg, &scanlines[jpeg->output_scanline],
-                        jpeg->output_height - jpeg->output_scanline);
+  while(m_jpeg->output_scanline < m_jpeg->output_height) {
+    jpeg_read_scanlines(m_jpeg, &scanlines[m_jpeg->output_scanline],
+                        m_jpeg->output_height - m_jpeg->output_scanline);
+    scanlinesRead(m_jpeg->output_scanline);
   }
 
-  jpeg_finish_decompress(jpeg);
+  jpeg_finish_decompress(m_jpeg);
 }
@@ -26,6 +26,7 @@
 #include "docker.hpp"
 #include "resource.hpp"
 #include "settings.hpp"
+#include "thread_pool.hpp"
 #include "window.hpp"
 
 #include <imgui/imgui.h>
@@ -123,6 +124,7 @@ extern "C" REAPER_PLUGIN_DLL_EXPORT int REAPER_PLUGIN_ENTRYPOINT(
   if(!rec) {
     API::announceAll(false);
     Resource::destroyAll(); // save context settings
+    ThreadPool::shutdown();
     Settings::teardown();
     Action::teardown();
     return 0;
@@ -47,6 +47,12 @@ constexpr uint8_t SHADER_LIBRARY[] {
 
 enum Bufers { VertexBuf, IndexBuf };
 
+static MTLPixelFormat pixelFormat(const Texture::Format format)
+{
+  return format == Texture::RGBA8 ? MTLPixelFormatRGBA8Unorm
+                                  : MTLPixelFormatR8Unorm;
+}
+
 class MetalRenderer final : public Renderer {
 public:
   MetalRenderer(RendererFactory *, Window *);
@@ -70,6 +76,7 @@ private:
 
     TextureCookie m_cookie;
     std::vector<id<MTLTexture>> m_textures;
+    std::vector<int> m_formats; // Texture::Format for the fragment shader
   };
 
   void resizeBuffer(size_t buf,
@@ -165,12 +172,36 @@ void MetalRenderer::Shared::textureCommand(const TextureCmd &cmd)
   switch(cmd.type) {
   case TextureCmd::Insert:
     m_textures.insert(m_textures.begin() + cmd.offset, cmd.size, nil);
+    m_formats.insert(m_formats.begin() + cmd.offset, cmd.size, Texture::RGBA8);
     break;
   case TextureCmd::Update:
+    for(size_t i {}; i < cmd.size; ++i) {
+      const Texture::Format format { cmd[i].format() };
+      Texture::Region region;
+      if(m_textures[cmd.offset + i].pixelFormat != pixelFormat(format) ||
+          !cmd.updateRegion(i, &region)) {
+        m_textures[cmd.offset + i] = nil; // re-created below
+        continue;
+      }
+      m_formats[cmd.offset + i] = format; // may be Alpha8 or Distance8
+
+      // modify the existing texture in place
+      int width, height;
+      const unsigned char *pixels { cmd[i].getPixels(&width, &height) };
+      const int bpp { Texture::bytesPerPixel(format) };
+      [m_textures[cmd.offset + i]
+        replaceRegion:MTLRegionMake2D(region.left, region.top,
+                                      region.width(), region.height())
+          mipmapLevel:0
+            withBytes:pixels + ((region.top * width) + region.left) * bpp
+          bytesPerRow:width * bpp];
+    }
     break;
   case TextureCmd::Remove:
     m_textures.erase(m_textures.begin() + cmd.offset,
                      m_textures.begin() + cmd.offset + cmd.size);
+    m_formats.erase(m_formats.begin() + cmd.offset,
+                    m_formats.begin() + cmd.offset + cmd.size);
     return;
   }
 
@@ -180,11 +211,15 @@ void MetalRenderer::Shared::textureCommand(const TextureCmd &cmd)
     throw backend_error { "failed to import MTLTextureDescriptor" };
 
   for(size_t i {}; i < cmd.size; ++i) {
+    if(m_textures[cmd.offset + i])
+      continue; // updated in place
+
     int width, height;
     const unsigned char *pixels { cmd[i].getPixels(&width, &height) };
+    const Texture::Format format { cmd[i].format() };
 
     MTLTextureDescriptor *texDesc =
-      [_MTLTextureDescriptor texture2DDescriptorWithPixelFormat:MTLPixelFormatRGBA8Unorm
+      [_MTLTextureDescriptor texture2DDescriptorWithPixelFormat:pixelFormat(format)
                                                           width:width
                                                          height:height
                                                       mipmapped:NO];
@@ -197,8 +232,9 @@ void MetalRenderer::Shared::textureCommand(const TextureCmd &cmd)
     [texture replaceRegion:MTLRegionMake2D(0, 0, width, height)
                mipmapLevel:0
                  withBytes:pixels
-               bytesPerRow:width * 4];
+               bytesPerRow:width * Texture::bytesPerPixel(format)];
     m_textures[cmd.offset + i] = texture;
+    m_formats[cmd.offset + i] = format;
   }
 }
 
@@ -339,7 +375,10 @@ void MetalRenderer::render(void *)
         .height = static_cast<NSUInteger>(clipRect.bottom - clipRect.top),
       }];
 
-      [commandEncoder setFragmentTexture:m_shared->m_textures[cmd->GetTexID()] atIndex:0];
+      const size_t texture { cmd->GetTexID() };
+      const int &format { m_shared->m_formats[texture] };
+      [commandEncoder setFragmentTexture:m_shared->m_textures[texture] atIndex:0];
+      [commandEncoder setFragmentBytes:&format length:sizeof(format) atIndex:0];
       [commandEncoder setVertexBufferOffset:vtxOffset + (cmd->VtxOffset * sizeof(ImDrawVert)) atIndex:0];
       [commandEncoder drawIndexedPrimitives:MTLPrimitiveTypeTriangle
                                  indexCount:cmd->ElemCount
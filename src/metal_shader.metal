@@ -29,12 +29,19 @@ vertex VertexOut vertex_main(VertexIn in [[stage_in]],
 }
 
 fragment half4 fragment_main(VertexOut in [[stage_in]],
-  texture2d<half, access::sample> texture [[texture(0)]])
+  texture2d<half, access::sample> texture [[texture(0)]],
+  constant int &format [[buffer(0)]]) // see Texture::Format
 {
   // sampler parameters are documented at page 39
   // "Table 2.7. Sampler state enumeration values"
   // https://developer.apple.com/metal/Metal-Shading-Language-Specification.pdf
   constexpr sampler linearSampler { address::repeat, filter::linear };
-  const half4 texColor = texture.sample(linearSampler, in.texCoords);
+  half4 texColor = texture.sample(linearSampler, in.texCoords);
+  if(format == 1) // single channel font atlas
+    texColor = half4(1, 1, 1, texColor.r);
+  else if(format == 2) { // signed distance field, edges at 0.5
+    half width = max(fwidth(texColor.r) * 0.5h, 1.0h / 255.0h);
+    texColor = half4(1, 1, 1, smoothstep(0.5h - width, 0.5h + width, texColor.r));
+  }
   return half4(in.color) * texColor;
 }
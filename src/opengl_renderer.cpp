@@ -28,11 +28,22 @@
 constexpr int GL_TEXTURE_WRAP_S { 0x2802 },
               GL_TEXTURE_WRAP_T { 0x2803 },
               GL_REPEAT         { 0x2901 };
+// not defined by every version of the loader
+#  ifndef GL_RED
+#    define GL_RED 0x1903
+#  endif
+#  ifndef GL_R8
+#    define GL_R8 0x8229
+#  endif
+#  ifndef GL_UNPACK_ALIGNMENT
+#    define GL_UNPACK_ALIGNMENT 0x0CF5
+#  endif
 #else
 #  include <epoxy/gl.h>
 #endif
 
 #include <imgui/imgui.h>
+#include <optional>
 
 REGISTER_RENDERER(90, opengl3, "OpenGL 3.2", OpenGLRenderer::creator);
 
@@ -60,6 +71,7 @@ constexpr const char *FRAGMENT_SHADER { R"(
 #version 150
 
 uniform sampler2D Texture;
+uniform int Format; // see Texture::Format
 
 in vec2 Frag_UV;
 in vec4 Frag_Color;
@@ -68,14 +80,21 @@ out vec4 Out_Color;
 
 void main()
 {
-  Out_Color = Frag_Color * texture(Texture, Frag_UV.st);
+  vec4 texel = texture(Texture, Frag_UV.st);
+  if(Format == 1) // single channel font atlas
+    texel = vec4(1.0, 1.0, 1.0, texel.r);
+  else if(Format == 2) { // signed distance field, edges at 0.5
+    float width = max(fwidth(texel.r) * 0.5, 1.0 / 255.0);
+    texel = vec4(1.0, 1.0, 1.0, smoothstep(0.5 - width, 0.5 + width, texel.r));
+  }
+  Out_Color = Frag_Color * texel;
 }
 )" };
 
 // these must match with the sizes of the corresponding member arrays
 enum Buffers   { VertexBuf, IndexBuf };
 enum Textures  { FontTex };
-enum Locations { ProjMtxUniLoc, TexUniLoc,
+enum Locations { ProjMtxUniLoc, TexUniLoc, FormatUniLoc,
                  VtxColorAttrLoc, VtxPosAttrLoc, VtxUVAttrLoc };
 
 void OpenGLRenderer::Shared::setup()
@@ -100,6 +119,7 @@ void OpenGLRenderer::Shared::setup()
 
   m_locations[ProjMtxUniLoc]   = glGetUniformLocation(m_program, "ProjMtx");
   m_locations[TexUniLoc]       = glGetUniformLocation(m_program, "Texture");
+  m_locations[FormatUniLoc]    = glGetUniformLocation(m_program, "Format");
   m_locations[VtxColorAttrLoc] = glGetAttribLocation(m_program,  "Color");
   m_locations[VtxPosAttrLoc]   = glGetAttribLocation(m_program,  "Position");
   m_locations[VtxUVAttrLoc]    = glGetAttribLocation(m_program,  "UV");
@@ -119,24 +139,49 @@ void OpenGLRenderer::Shared::textureCommand(const TextureCmd &cmd)
   switch(cmd.type) {
   case TextureCmd::Insert:
     m_textures.insert(m_textures.begin() + cmd.offset, cmd.size, 0);
+    m_formats.insert(m_formats.begin() + cmd.offset, cmd.size, Texture::RGBA8);
     glGenTextures(cmd.size, m_textures.data() + cmd.offset);
     [[fallthrough]];
   case TextureCmd::Update:
     for(size_t i {}; i < cmd.size; ++i) {
       int width, height;
       const unsigned char *pixels { cmd[i].getPixels(&width, &height) };
+      const Texture::Format format { cmd[i].format() };
+      const int bpp { Texture::bytesPerPixel(format) };
+      const bool alphaOnly { bpp == 1 };
+      Texture::Format &uploadedFormat { m_formats[cmd.offset + i] };
       glBindTexture(GL_TEXTURE_2D, m_textures[cmd.offset + i]);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, alphaOnly ? 1 : 4);
+
+      if(Texture::Region region;
+          uploadedFormat == format && cmd.updateRegion(i, &region)) {
+        // modify the existing texture in place
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, region.left, region.top,
+          region.width(), region.height(), alphaOnly ? GL_RED : GL_RGBA,
+          GL_UNSIGNED_BYTE,
+          pixels + ((region.top * width) + region.left) * bpp);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        continue;
+      }
+
+      uploadedFormat = format;
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+      glTexImage2D(GL_TEXTURE_2D, 0, alphaOnly ? GL_R8 : GL_RGBA,
+        width, height, 0, alphaOnly ? GL_RED : GL_RGBA,
+        GL_UNSIGNED_BYTE, pixels);
     }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
     break;
   case TextureCmd::Remove:
     glDeleteTextures(cmd.size, m_textures.data() + cmd.offset);
     m_textures.erase(m_textures.begin() + cmd.offset,
                      m_textures.begin() + cmd.offset + cmd.size);
+    m_formats.erase(m_formats.begin() + cmd.offset,
+                    m_formats.begin() + cmd.offset + cmd.size);
     break;
   }
 }
@@ -223,6 +268,9 @@ void OpenGLRenderer::render(const bool flip)
   const ProjMtx projMtx { drawData->DisplayPos, drawData->DisplaySize, flip };
   glUniformMatrix4fv(m_shared->m_locations[ProjMtxUniLoc], 1, GL_FALSE, &projMtx);
 
+  // the program is shared, its uniforms may have been set by another window
+  std::optional<Texture::Format> format;
+
   const ImVec2 &clipOffset { drawData->DisplayPos },
                &clipScale  { viewport->DpiScale, viewport->DpiScale };
   for(int i { 0 }; i < drawData->CmdListsCount; ++i) {
@@ -247,7 +295,12 @@ void OpenGLRenderer::render(const bool flip)
         clipRect.right - clipRect.left, clipRect.bottom - clipRect.top);
 
       // Bind texture, Draw
-      glBindTexture(GL_TEXTURE_2D, m_shared->m_textures[cmd->GetTexID()]);
+      const size_t texture { cmd->GetTexID() };
+      glBindTexture(GL_TEXTURE_2D, m_shared->m_textures[texture]);
+      if(format != m_shared->m_formats[texture]) {
+        format = m_shared->m_formats[texture];
+        glUniform1i(m_shared->m_locations[FormatUniLoc], *format);
+      }
       glDrawElementsBaseVertex(GL_TRIANGLES, cmd->ElemCount,
         sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
         (void*)(intptr_t)(cmd->IdxOffset * sizeof(ImDrawIdx)),
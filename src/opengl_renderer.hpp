@@ -43,7 +43,8 @@ protected:
     unsigned int m_program;
     TextureCookie m_cookie;
     std::vector<unsigned int> m_textures;
-    std::array<unsigned int, 5> m_locations;
+    std::vector<Texture::Format> m_formats; // as uploaded
+    std::array<unsigned int, 6> m_locations;
     std::shared_ptr<void> m_platform;
   };
 
@@ -19,36 +19,52 @@
 
 #include "error.hpp"
 
+#include <cstring> // memcpy
 #include <png.h>   // http://www.libpng.org/pub/png/libpng-manual.txt
-#include <cstring> // strerror
 
 constexpr size_t HEADER_SIZE { 8 }; // must not be > 8
 
-class PNGImage final : public Bitmap {
+class PNGDecoder final : public Image::Decoder {
 public:
-  PNGImage(std::istream &);
+  struct Reader {
+    const unsigned char *pos, *end;
+  };
+
+  PNGDecoder(const unsigned char *data, size_t size);
+
+protected:
+  bool readsRowsInOrder() const override;
+  void readScanlines(unsigned char **) override;
+
+private:
+  struct PNG {
+    ~PNG() { png_destroy_read_struct(&read, &info, nullptr); }
+    png_structp read {};
+    png_infop   info {};
+  } m_png;
+  Reader m_reader;
 };
 
-static bool isPNG(std::istream &stream)
+static bool isPNG(const unsigned char *data, const size_t size)
 {
-  png_byte header[HEADER_SIZE];
-  if(!stream.read(reinterpret_cast<char *>(header), sizeof(header)))
-    return false;
-  return png_check_sig(header, sizeof(header));
+  return size >= HEADER_SIZE && !png_sig_cmp(data, 0, HEADER_SIZE);
 }
 
-static Image *create(std::istream &stream)
+static std::unique_ptr<Image::Decoder> create(const unsigned char *data,
+  const size_t size)
 {
-  return new PNGImage(stream);
+  return std::make_unique<PNGDecoder>(data, size);
 }
 
 static const Image::RegisterType PNG { &isPNG, &create };
 
 static void read(png_structp png, png_bytep data, const png_size_t length)
 {
-  std::istream &stream { *static_cast<std::istream *>(png_get_io_ptr(png)) };
-  if(!stream.read(reinterpret_cast<char *>(data), length))
-    png_error(png, stream.eof() ? "premature end of file" : strerror(errno));
+  auto reader { static_cast<PNGDecoder::Reader *>(png_get_io_ptr(png)) };
+  if(static_cast<size_t>(reader->end - reader->pos) < length)
+    png_error(png, "premature end of file");
+  memcpy(data, reader->pos, length);
+  reader->pos += length;
 }
 
 static void error(png_structp, const char *what)
@@ -85,31 +101,43 @@ static void transformToRGBA(png_structp png, png_infop info)
   png_read_update_info(png, info);
 }
 
-PNGImage::PNGImage(std::istream &stream)
+PNGDecoder::PNGDecoder(const unsigned char *data, const size_t size)
+  : m_reader { data + HEADER_SIZE, data + size }
 {
-  struct PNG {
-    ~PNG() { png_destroy_read_struct(&read, &info, nullptr); }
-    png_structp read;
-    png_infop   info;
-  } png;
-
-  if(!(png.read =
+  if(!(m_png.read =
       png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, error, nullptr)))
     throw reascript_error { "failed to create PNG read structure" };
-  if(!(png.info = png_create_info_struct(png.read)))
+  if(!(m_png.info = png_create_info_struct(m_png.read)))
     throw reascript_error { "failed to create PNG info structure" };
 
-  // png_set_user_limits(png.read, maxWidth, maxHeight);
+  // png_set_user_limits(m_png.read, maxWidth, maxHeight);
+
+  png_set_read_fn(m_png.read, &m_reader, read);
+  png_set_sig_bytes(m_png.read, HEADER_SIZE);
+  png_read_info(m_png.read, m_png.info);
+  transformToRGBA(m_png.read, m_png.info);
 
-  png_set_read_fn(png.read, &stream, read);
-  png_set_sig_bytes(png.read, HEADER_SIZE);
-  png_read_info(png.read, png.info);
-  transformToRGBA(png.read, png.info);
+  setSize(png_get_image_width(m_png.read,  m_png.info),
+          png_get_image_height(m_png.read, m_png.info),
+          png_get_rowbytes(m_png.read,     m_png.info) /
+          png_get_image_width(m_png.read,  m_png.info));
+}
 
-  resize(png_get_image_width(png.read,  png.info),
-         png_get_image_height(png.read, png.info),
-         png_get_rowbytes(png.read,     png.info) /
-         png_get_image_width(png.read,  png.info));
+bool PNGDecoder::readsRowsInOrder() const
+{
+  // interlaced images are only complete after the last pass
+  return png_get_interlace_type(m_png.read, m_png.info) == PNG_INTERLACE_NONE;
+}
 
-  png_read_image(png.read, makeScanlines().data());
+void PNGDecoder::readScanlines(unsigned char **scanlines)
+{
+  if(!readsRowsInOrder()) {
+    png_read_image(m_png.read, scanlines);
+    return;
+  }
+
+  for(size_t y {}; y < scanlineCount(); ++y) {
+    png_read_row(m_png.read, scanlines[y], nullptr);
+    scanlinesRead(y + 1);
+  }
 }
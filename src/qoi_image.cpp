@@ -0,0 +1,124 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "image.hpp"
+
+#include "error.hpp"
+#include "image_formats.hpp"
+
+#include <cstring> // memcmp, memcpy
+
+class QOIDecoder final : public Image::Decoder {
+public:
+  QOIDecoder(const unsigned char *data, size_t size);
+
+protected:
+  void readScanlines(unsigned char **) override;
+
+private:
+  const unsigned char *m_data, *m_end;
+};
+
+static bool isQOI(const unsigned char *data, const size_t size)
+{
+  return size >= QOI::HEADER_SIZE &&
+    !memcmp(data, QOI::MAGIC, sizeof(QOI::MAGIC));
+}
+
+static std::unique_ptr<Image::Decoder> create(const unsigned char *data,
+  const size_t size)
+{
+  return std::make_unique<QOIDecoder>(data, size);
+}
+
+static const Image::RegisterType QOI_TYPE { &isQOI, &create };
+
+QOIDecoder::QOIDecoder(const unsigned char *data, const size_t size)
+  : m_data { data + QOI::HEADER_SIZE }, m_end { data + size }
+{
+  const size_t width  { readBigEndian32(data + 4) },
+               height { readBigEndian32(data + 8) };
+  if(!width || !height || width * height > QOI::MAX_PIXELS)
+    throw reascript_error { "invalid QOI image size" };
+
+  setSize(width, height, 4); // always decoded to RGBA
+}
+
+void QOIDecoder::readScanlines(unsigned char **scanlines)
+{
+  unsigned char index[64][4] {};
+  unsigned char px[4] { 0, 0, 0, 255 };
+  unsigned int run {};
+
+  // chunks cannot overlap the end marker
+  const unsigned char *in { m_data }, *end { m_end - sizeof(QOI::END_MARKER) };
+  const auto need { [&](const ptrdiff_t bytes) {
+    if(end - in < bytes)
+      throw reascript_error { "premature end of QOI data" };
+  } };
+
+  for(size_t y {}; y < scanlineCount(); ++y) {
+    unsigned char *out { scanlines[y] };
+    const unsigned char *rowEnd { out + (scanlineWidth() * 4) };
+    for(; out < rowEnd; out += 4) {
+      if(run > 0)
+        --run;
+      else {
+        need(1);
+        const unsigned char op { *in++ };
+        if(op == QOI::OP_RGB) {
+          need(3);
+          memcpy(px, in, 3);
+          in += 3;
+        }
+        else if(op == QOI::OP_RGBA) {
+          need(4);
+          memcpy(px, in, 4);
+          in += 4;
+        }
+        else switch(op & QOI::OP_MASK) {
+        case QOI::OP_INDEX:
+          memcpy(px, index[op], 4);
+          break;
+        case QOI::OP_DIFF:
+          px[0] += ((op >> 4) & 3) - 2;
+          px[1] += ((op >> 2) & 3) - 2;
+          px[2] += ( op       & 3) - 2;
+          break;
+        case QOI::OP_LUMA: {
+          need(1);
+          const unsigned char next { *in++ };
+          const int dg { (op & 0x3f) - 32 };
+          px[0] += dg - 8 + ((next >> 4) & 0x0f);
+          px[1] += dg;
+          px[2] += dg - 8 + (next & 0x0f);
+          break;
+        }
+        case QOI::OP_RUN:
+          run = op & 0x3f;
+          break;
+        }
+
+        memcpy(index[QOI::hash(px)], px, 4);
+      }
+
+      memcpy(out, px, 4);
+    }
+
+    scanlinesRead(y + 1);
+  }
+}
@@ -0,0 +1,72 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "image.hpp"
+
+#include "error.hpp"
+#include "image_formats.hpp"
+
+#include <cstring> // memcmp, memcpy
+
+class RawDecoder final : public Image::Decoder {
+public:
+  RawDecoder(const unsigned char *data, size_t size);
+
+protected:
+  void readScanlines(unsigned char **) override;
+
+private:
+  const unsigned char *m_data;
+};
+
+static bool isRaw(const unsigned char *data, const size_t size)
+{
+  return size >= RawRGBA::HEADER_SIZE &&
+    !memcmp(data, RawRGBA::MAGIC, sizeof(RawRGBA::MAGIC));
+}
+
+static std::unique_ptr<Image::Decoder> create(const unsigned char *data,
+  const size_t size)
+{
+  return std::make_unique<RawDecoder>(data, size);
+}
+
+static const Image::RegisterType RAW { &isRaw, &create };
+
+RawDecoder::RawDecoder(const unsigned char *data, const size_t size)
+  : m_data { data + RawRGBA::HEADER_SIZE }
+{
+  const size_t width  { readBigEndian32(data + sizeof(RawRGBA::MAGIC))     },
+               height { readBigEndian32(data + sizeof(RawRGBA::MAGIC) + 4) };
+  if(!width || !height)
+    throw reascript_error { "invalid image size" };
+  else if((size - RawRGBA::HEADER_SIZE) / 4 / width < height)
+    throw reascript_error { "premature end of file" };
+
+  setSize(width, height, 4);
+}
+
+void RawDecoder::readScanlines(unsigned char **scanlines)
+{
+  // nothing to decode, only copy the rows out of the file
+  const size_t rowSize { scanlineWidth() * 4 };
+  const unsigned char *in { m_data };
+  for(size_t y {}; y < scanlineCount(); ++y, in += rowSize) {
+    memcpy(scanlines[y], in, rowSize);
+    scanlinesRead(y + 1);
+  }
+}
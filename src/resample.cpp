@@ -0,0 +1,149 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resample.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+constexpr size_t CHANNELS { 4 };
+
+using Reducer = Resample::Reducer;
+
+Reducer::Coverage::Coverage(const size_t srcSize, const size_t dstSize)
+  : first(dstSize), count(dstSize), offset(dstSize)
+{
+  const double ratio { static_cast<double>(srcSize) / dstSize };
+  weights.reserve(static_cast<size_t>(std::ceil(ratio) + 1) * dstSize);
+
+  for(size_t i {}; i < dstSize; ++i) {
+    const double start { i * ratio }, end { (i + 1) * ratio };
+    first[i] = static_cast<size_t>(start);
+    const size_t last
+      { std::min(srcSize, static_cast<size_t>(std::ceil(end))) };
+    count[i]  = last - first[i];
+    offset[i] = weights.size();
+
+    for(size_t j { first[i] }; j < last; ++j) {
+      const double overlap { std::min<double>(j + 1, end) -
+                             std::max<double>(j, start) };
+      weights.push_back(overlap / ratio);
+    }
+  }
+}
+
+void Resample::downscale(
+  const unsigned char *src, const size_t srcWidth, const size_t srcHeight,
+  unsigned char *dst, const size_t dstWidth, const size_t dstHeight)
+{
+  Reducer reducer { srcWidth, srcHeight, dstWidth, dstHeight };
+  const size_t srcStride { srcWidth * CHANNELS },
+               dstStride { dstWidth * CHANNELS };
+  for(size_t y {}; y < srcHeight; ++y, src += srcStride) {
+    if(const unsigned char *row { reducer.push(src) })
+      dst = std::copy(row, row + dstStride, dst);
+  }
+}
+
+Reducer::Reducer(const size_t srcWidth, const size_t srcHeight,
+  const size_t dstWidth, const size_t dstHeight)
+  : m_srcStride { srcWidth * CHANNELS }, m_dstWidth { dstWidth },
+    m_cols { srcWidth, dstWidth }, m_rows { srcHeight, dstHeight },
+    m_srcRow {}, m_dstRow {},
+    m_premul(m_srcStride), m_accum(m_srcStride), m_nextAccum(m_srcStride),
+    m_out(dstWidth * CHANNELS)
+{
+}
+
+const unsigned char *Reducer::push(const unsigned char *line)
+{
+  const size_t dstHeight { m_rows.first.size() };
+  if(m_dstRow >= dstHeight)
+    return nullptr;
+
+  // Each source row is blended vertically into the destination rows it
+  // covers with a plain multiply-add loop that compilers vectorize, which
+  // are then reduced horizontally once complete. Colors are weighted by their
+  // alpha so that fully transparent pixels do not bleed into their neighbors.
+  for(size_t x {}; x < m_srcStride; x += CHANNELS) {
+    const float alpha { static_cast<float>(line[x + 3]) };
+    m_premul[x + 0] = line[x + 0] * alpha;
+    m_premul[x + 1] = line[x + 1] * alpha;
+    m_premul[x + 2] = line[x + 2] * alpha;
+    m_premul[x + 3] = alpha;
+  }
+
+  const size_t srcRow { m_srcRow++ };
+  const auto accumulate { [&](std::vector<float> &accum, const size_t y) {
+    const float weight
+      { m_rows.weights[m_rows.offset[y] + (srcRow - m_rows.first[y])] };
+    for(size_t x {}; x < m_srcStride; ++x)
+      accum[x] += m_premul[x] * weight;
+  } };
+
+  accumulate(m_accum, m_dstRow);
+  const size_t next { m_dstRow + 1 };
+  const bool shared { next < dstHeight && srcRow >= m_rows.first[next] };
+  if(shared)
+    accumulate(m_nextAccum, next);
+
+  if(srcRow + 1 < m_rows.first[m_dstRow] + m_rows.count[m_dstRow])
+    return nullptr;
+
+  unsigned char *dst { m_out.data() };
+  const float *colWeight { m_cols.weights.data() };
+  for(size_t x {}; x < m_dstWidth; ++x) {
+    float pixel[CHANNELS] {};
+    const float *in { &m_accum[m_cols.first[x] * CHANNELS] };
+    for(size_t i {}; i < m_cols.count[x]; ++i, in += CHANNELS) {
+      const float weight { *colWeight++ };
+      for(size_t c {}; c < CHANNELS; ++c)
+        pixel[c] += in[c] * weight;
+    }
+
+    const float alpha { pixel[3] };
+    const float unpremul { alpha > 0.f ? 1.f / alpha : 0.f };
+    for(size_t c {}; c < 3; ++c)
+      *dst++ = std::min(255.f, std::round(pixel[c] * unpremul));
+    *dst++ = std::min(255.f, std::round(alpha));
+  }
+
+  m_accum.swap(m_nextAccum);
+  std::fill(m_nextAccum.begin(), m_nextAccum.end(), 0.f);
+  ++m_dstRow;
+
+  return m_out.data();
+}
+
+void Resample::fit(size_t *width, size_t *height,
+  const size_t maxWidth, const size_t maxHeight)
+{
+  if(!*width || !*height)
+    return;
+
+  double scale { 1.0 };
+  if(maxWidth)
+    scale = std::min(scale, static_cast<double>(maxWidth) / *width);
+  if(maxHeight)
+    scale = std::min(scale, static_cast<double>(maxHeight) / *height);
+  if(scale >= 1.0)
+    return;
+
+  *width  = std::max<size_t>(1, std::round(*width  * scale));
+  *height = std::max<size_t>(1, std::round(*height * scale));
+}
@@ -0,0 +1,63 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAIMGUI_RESAMPLE_HPP
+#define REAIMGUI_RESAMPLE_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace Resample {
+  // Area-averaging reduction of tightly packed RGBA8 pixels.
+  // The destination must not be larger than the source in either dimension.
+  void downscale(const unsigned char *src, size_t srcWidth, size_t srcHeight,
+                 unsigned char *dst, size_t dstWidth, size_t dstHeight);
+
+  // Same as downscale, receiving the source rows one at a time from the top
+  // so that the whole source image never needs to be in memory.
+  class Reducer {
+  public:
+    Reducer(size_t srcWidth, size_t srcHeight,
+            size_t dstWidth, size_t dstHeight);
+
+    // returns the next destination row if completed by this source row
+    const unsigned char *push(const unsigned char *srcRow);
+
+  private:
+    // source pixels covered by each destination pixel along one axis
+    struct Coverage {
+      Coverage(size_t srcSize, size_t dstSize);
+
+      std::vector<size_t> first, count, offset;
+      std::vector<float> weights; // count[i] weights per destination pixel
+    };
+
+    const size_t m_srcStride, m_dstWidth;
+    const Coverage m_cols, m_rows;
+    size_t m_srcRow, m_dstRow;
+    // vertical sums of the destination row being built and the next one
+    // (sharing a source row when the ratio is fractional)
+    std::vector<float> m_premul, m_accum, m_nextAccum;
+    std::vector<unsigned char> m_out;
+  };
+
+  // Largest size fitting within maxWidth x maxHeight (0 = unlimited)
+  // preserving the aspect ratio. Never upscales.
+  void fit(size_t *width, size_t *height, size_t maxWidth, size_t maxHeight);
+}
+
+#endif
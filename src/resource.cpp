@@ -19,9 +19,10 @@
 
 #include "context.hpp"
 #include "error.hpp"
-#include "flat_set.hpp"
+#include "slot_set.hpp"
 
 #include <cassert>
+#include <chrono>
 #include <reaper_plugin_functions.h>
 #include <WDL/wdltypes.h>
 
@@ -32,7 +33,14 @@
 // [p=2450259]
 constexpr unsigned int KEEP_ALIVE_FRAMES { 2 };
 
-static FlatSet<Resource *> g_rsx;
+// Unused resources are collected over multiple timer ticks when checking all
+// of them takes longer than this (the clock is read once per batch).
+constexpr std::chrono::microseconds COLLECT_BUDGET { 500 };
+constexpr size_t COLLECT_BATCH { 64 };
+
+static SlotSet<Resource *> g_rsx, g_beating;
+static unsigned int g_generation; // incremented on every unblocked tick
+static size_t g_collectCursor, g_collected;
 static unsigned int g_reentrant;
 static WNDPROC g_mainProc;
 static bool g_disableProcOverride;
@@ -55,6 +63,7 @@ public:
 
 private:
   static void tick();
+  static void collect();
   static LRESULT CALLBACK mainProcOverride(HWND, unsigned int, WPARAM, LPARAM);
 };
 
@@ -88,8 +97,9 @@ void Resource::Timer::tick()
 
 #ifndef __APPLE__
   if(blocked != g_disabledViewports) {
-    for(Resource *rs : g_rsx) {
-      if(Context *ctx { dynamic_cast<Context *>(rs) })
+    for(size_t i {}; i < g_beating.slots(); ++i) {
+      Resource *rs { g_beating[i] };
+      if(Context *ctx { rs ? rs->as<Context>() : nullptr })
         ctx->enableViewports(!blocked);
     }
     g_disabledViewports = blocked;
@@ -99,17 +109,39 @@ void Resource::Timer::tick()
   if(blocked)
     return;
 
-  auto it { g_rsx.begin() };
+  ++g_generation;
 
-  while(it != g_rsx.end()) {
-    Resource *rs { *it };
-    if(rs->heartbeat())
-      ++it;
-    else {
-      delete rs; // invalidates the iterator
-      it = g_rsx.lowerBound(rs);
+  // destroyed resources leave their slot empty
+  for(size_t i {}; i < g_beating.slots(); ++i) {
+    Resource *rs { g_beating[i] };
+    if(rs && !rs->heartbeat()) {
+      delete rs;
+      ++g_collected;
     }
   }
+
+  collect();
+}
+
+void Resource::Timer::collect()
+{
+  using Clock = std::chrono::steady_clock;
+  const auto deadline { Clock::now() + COLLECT_BUDGET };
+
+  // resume where the previous tick stopped, visiting each slot at most once
+  for(size_t visited {}; visited < g_rsx.slots(); ++visited) {
+    if(g_collectCursor >= g_rsx.slots())
+      g_collectCursor = 0;
+
+    Resource *rs { g_rsx[g_collectCursor++] };
+    if(rs && rs->expired()) {
+      delete rs;
+      ++g_collected;
+    }
+
+    if(visited % COLLECT_BATCH == COLLECT_BATCH - 1 && Clock::now() >= deadline)
+      break;
+  }
 }
 
 LRESULT CALLBACK Resource::Timer::mainProcOverride(HWND hwnd,
@@ -132,7 +164,7 @@ LRESULT CALLBACK Resource::Timer::mainProcOverride(HWND hwnd,
 }
 
 Resource::Resource()
-  : m_keepAlive { KEEP_ALIVE_FRAMES }
+  : m_lastUse { g_generation }
 {
   static std::weak_ptr<Timer> g_timer;
 
@@ -147,20 +179,27 @@ Resource::Resource()
 Resource::~Resource()
 {
   g_rsx.erase(this);
+  g_beating.erase(this);
 }
 
 void Resource::keepAlive()
 {
-  m_keepAlive = KEEP_ALIVE_FRAMES;
+  m_lastUse = g_generation;
+}
+
+bool Resource::expired() const
+{
+  return g_generation - m_lastUse > KEEP_ALIVE_FRAMES;
 }
 
 bool Resource::heartbeat()
 {
-  if(!m_keepAlive)
-    return false;
+  return !expired();
+}
 
-  --m_keepAlive;
-  return true;
+void Resource::enableHeartbeat()
+{
+  g_beating.insert(this);
 }
 
 bool Resource::isValid() const
@@ -171,11 +210,18 @@ bool Resource::isValid() const
 template<>
 bool Resource::isValid<Resource>(Resource *rs)
 {
-  return g_rsx.contains(rs) && rs->isValid();
+  // expired resources may not have been collected yet
+  return g_rsx.contains(rs) && !rs->expired() && rs->isValid();
 }
 
 void Resource::destroyAll()
 {
-  while(!g_rsx.empty())
-    delete g_rsx.back();
+  for(size_t i { g_rsx.slots() }; i-- > 0;)
+    delete g_rsx[i];
+}
+
+void Resource::stats(size_t *live, size_t *collected)
+{
+  *live = g_rsx.size();
+  *collected = g_collected;
 }
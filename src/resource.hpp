@@ -18,12 +18,42 @@
 #ifndef REAIMGUI_RESOURCE_HPP
 #define REAIMGUI_RESOURCE_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <type_traits>
 
 class Context;
 
 class Resource {
 public:
+  // Identifies a class and its ancestors using one byte per level of
+  // inheritance, for checking types without RTTI. See TypedResource.
+  class Type {
+  public:
+    constexpr Type() : m_bits {}, m_mask {} {}
+    constexpr Type(const Type &parent, const uint8_t id)
+      : m_bits { parent.m_bits | (uint32_t { id } << (parent.depth() * 8)) },
+        m_mask { parent.m_mask | (0xFFu << (parent.depth() * 8)) } {}
+
+    constexpr unsigned int depth() const
+    {
+      unsigned int depth {};
+      for(uint32_t mask { m_mask }; mask; mask >>= 8)
+        ++depth;
+      return depth;
+    }
+
+    // whether this is the same class as the given one or a subclass of it
+    constexpr bool isA(const Type &other) const
+    {
+      return (m_bits & other.m_mask) == other.m_bits;
+    }
+
+  private:
+    uint32_t m_bits, m_mask;
+  };
+
   static constexpr const char *api_type_name { "ImGui_Resource" };
 
   Resource();
@@ -34,27 +64,103 @@ public:
 
   virtual bool attachable(const Context *) const = 0;
 
+  // null if not an instance of T or of a subclass of T
+  template<typename T>
+  T *as()
+  {
+    static_assert(std::is_same_v<typename T::resource_class, T>,
+      "the class must derive from TypedResource");
+    return m_type.isA(T::resource_type) ? static_cast<T *>(this) : nullptr;
+  }
+
   template<typename T>
   static bool isValid(T *userData)
   {
     static_assert(!std::is_same_v<Resource, T>);
 
-    // short-circuiting dynamic_cast for faster exact type match
     Resource *resource { static_cast<Resource *>(userData) };
-    return isValid(resource) &&
-      (typeid(*resource) == typeid(T) || dynamic_cast<T *>(resource));
+    if constexpr(std::is_void_v<T>)
+      return isValid(resource);
+    else
+      return isValid(resource) && resource->as<std::remove_cv_t<T>>();
   }
 
   static void destroyAll();
+  static void stats(size_t *live, size_t *collected);
 
 protected:
+  // Called on every timer tick once enabled, for resources doing work
+  // or keeping other resources alive. Return false to be destroyed.
+  // Other resources are destroyed in the background once unused.
   virtual bool heartbeat();
+  void enableHeartbeat();
   virtual bool isValid() const;
 
 private:
+  template<typename, typename, uint8_t>
+  friend class TypedResource;
+
+  bool expired() const;
+
   class Timer;
   std::shared_ptr<Timer> m_timer;
-  unsigned int m_keepAlive;
+  Type m_type; // of the most derived class
+  unsigned int m_lastUse; // timer generation of the last keepAlive
+};
+
+// IDs of the direct subclasses of each resource class for TypedResource.
+// They must be unique among the subclasses of the same parent: keep them
+// all here (one enum per parent) so that duplicates are visible.
+enum ResourceSubclass : uint8_t {
+  ResourceSubclass_Context = 1,
+  ResourceSubclass_Font,
+  ResourceSubclass_Image,
+  ResourceSubclass_DrawListSplitter,
+  ResourceSubclass_TextFilter,
+  ResourceSubclass_ListClipper,
+
+  // for the unit tests
+  ResourceSubclass_Test1 = 0xF0,
+  ResourceSubclass_Test2,
+};
+
+enum ImageSubclass : uint8_t {
+  ImageSubclass_Bitmap = 1,
+  ImageSubclass_PixelImage,
+  ImageSubclass_ImageSet,
+};
+
+// Base of resource classes giving them a type tag derived from the one of
+// their parent, eg. `class Bitmap :
+//   public TypedResource<Bitmap, Image, ImageSubclass_Bitmap>`.
+template<typename Self, typename Parent, uint8_t Id>
+class TypedResource : public Parent {
+public:
+  static_assert(std::is_base_of_v<Resource, Parent>);
+  static_assert(Id > 0, "0 is the ID of the parent itself");
+
+private:
+  static constexpr Resource::Type parentType()
+  {
+    if constexpr(std::is_same_v<Parent, Resource>)
+      return {};
+    else
+      return Parent::resource_type;
+  }
+
+  static_assert(parentType().depth() < sizeof(uint32_t),
+    "too many levels of inheritance");
+
+public:
+  using resource_class = Self;
+  static constexpr Resource::Type resource_type { parentType(), Id };
+
+protected:
+  TypedResource()
+  {
+    // overwritten by the constructors of typed subclasses (which run later)
+    Resource::m_type = resource_type;
+  }
 };
 
 template<>
@@ -0,0 +1,71 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAIMGUI_SLOT_SET_HPP
+#define REAIMGUI_SLOT_SET_HPP
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+// meant to store pointers with constant-time insertion, removal and lookup
+// removing a value frees its slot (reused later) without moving the others,
+// so the slots can be iterated by index while values are being removed
+// caller is responsible for not inserting the same value more than once
+//
+// Unlike a slot map, there are no generation counters: values are looked up
+// by themselves, so a pointer to a removed object is found again if the same
+// address is inserted later.
+template<typename T>
+class SlotSet {
+public:
+  size_t slots() const { return m_slots.size(); }
+  T operator[](const size_t i) const { return m_slots[i]; } // null if free
+  size_t size() const { return m_index.size();  }
+  bool empty()  const { return m_index.empty(); }
+  bool contains(T v) const { return m_index.count(v) > 0; }
+
+  void insert(T v)
+  {
+    size_t slot { m_slots.size() };
+    if(m_free.empty())
+      m_slots.push_back(v);
+    else {
+      slot = m_free.back();
+      m_free.pop_back();
+      m_slots[slot] = v;
+    }
+    m_index.emplace(v, slot);
+  }
+
+  void erase(T v)
+  {
+    const auto it { m_index.find(v) };
+    if(it == m_index.end())
+      return;
+    m_slots[it->second] = nullptr;
+    m_free.push_back(it->second);
+    m_index.erase(it);
+  }
+
+private:
+  std::vector<T> m_slots;
+  std::vector<size_t> m_free;
+  std::unordered_map<T, size_t> m_index;
+};
+
+#endif
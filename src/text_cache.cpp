@@ -0,0 +1,86 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "text_cache.hpp"
+
+#include <functional>
+
+TextCache::TextCache(const size_t capacity)
+  : m_capacity { capacity }, m_version {}, m_hits {}, m_misses {}
+{
+}
+
+size_t TextCache::hash(const Key &key)
+{
+  size_t hash { std::hash<std::string_view>{}(key.text) };
+  for(const size_t value : { std::hash<const void *>{}(key.font),
+      std::hash<float>{}(key.fontSize), std::hash<float>{}(key.wrapWidth),
+      static_cast<size_t>(key.hideAfterDoubleHash) })
+    hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  return hash;
+}
+
+bool TextCache::Item::operator==(const Key &key) const
+{
+  return font == key.font && fontSize == key.fontSize &&
+         wrapWidth == key.wrapWidth &&
+         hideAfterDoubleHash == key.hideAfterDoubleHash && text == key.text;
+}
+
+void TextCache::setVersion(const uint64_t version)
+{
+  if(version == m_version)
+    return;
+
+  m_version = version;
+  m_lru.clear();
+  m_index.clear();
+}
+
+bool TextCache::find(const Key &key, Size *size)
+{
+  const auto it { m_index.find(hash(key)) };
+  if(it == m_index.end() || !(*it->second == key)) {
+    ++m_misses;
+    return false;
+  }
+
+  ++m_hits;
+  m_lru.splice(m_lru.begin(), m_lru, it->second);
+  *size = it->second->size;
+  return true;
+}
+
+void TextCache::insert(const Key &key, const Size size)
+{
+  // also replaces an entry with a colliding hash
+  const size_t keyHash { hash(key) };
+  const auto it { m_index.find(keyHash) };
+  if(it != m_index.end()) {
+    m_lru.erase(it->second);
+    m_index.erase(it);
+  }
+
+  m_lru.push_front({ keyHash, key.font, key.fontSize, key.wrapWidth,
+    key.hideAfterDoubleHash, std::string { key.text }, size });
+  m_index.emplace(keyHash, m_lru.begin());
+
+  if(m_lru.size() > m_capacity) {
+    m_index.erase(m_lru.back().hash);
+    m_lru.pop_back();
+  }
+}
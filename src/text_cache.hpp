@@ -0,0 +1,74 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAIMGUI_TEXT_CACHE_HPP
+#define REAIMGUI_TEXT_CACHE_HPP
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Per-context memo of measured text sizes, for scripts measuring the same
+// strings every frame. Entries are only valid for a given version of the
+// font atlas (glyphs added on demand change the advances).
+class TextCache {
+public:
+  struct Key {
+    const void *font;
+    float fontSize, wrapWidth;
+    bool hideAfterDoubleHash;
+    std::string_view text;
+  };
+
+  struct Size { float width, height; };
+
+  TextCache(size_t capacity);
+  TextCache(const TextCache &) = delete;
+
+  // clears the cache if the version changed
+  void setVersion(uint64_t);
+  bool find(const Key &, Size *);
+  void insert(const Key &, Size);
+
+  size_t size() const { return m_lru.size(); }
+  unsigned int hits() const { return m_hits; }
+  unsigned int misses() const { return m_misses; }
+
+private:
+  struct Item {
+    size_t hash;
+    const void *font;
+    float fontSize, wrapWidth;
+    bool hideAfterDoubleHash;
+    std::string text;
+    Size size;
+
+    bool operator==(const Key &) const;
+  };
+
+  static size_t hash(const Key &);
+
+  const size_t m_capacity;
+  uint64_t m_version;
+  unsigned int m_hits, m_misses;
+  std::list<Item> m_lru; // most recently used first
+  std::unordered_map<size_t, std::list<Item>::iterator> m_index;
+};
+
+#endif
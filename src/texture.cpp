@@ -21,11 +21,54 @@
 #include <imgui/imgui.h>
 #include <iterator>
 
+void Texture::Region::extend(const Region &other)
+{
+  if(empty())
+    *this = other;
+  else if(!other.empty()) {
+    left   = std::min(left,   other.left);
+    top    = std::min(top,    other.top);
+    right  = std::max(right,  other.right);
+    bottom = std::max(bottom, other.bottom);
+  }
+}
+
+constexpr size_t MAX_HISTORY { 16 };
+
+void ChangeHistory::add(const unsigned int generation,
+  const Texture::Region &region)
+{
+  if(m_changes.size() == MAX_HISTORY)
+    m_changes.pop_front();
+  m_changes.emplace_back(generation, region);
+}
+
+bool ChangeHistory::since(const unsigned int since,
+  Texture::Region *region) const
+{
+  if(m_changes.empty() || m_changes.front().first > since + 1)
+    return false; // too old
+
+  *region = {};
+  for(const auto &[generation, change] : m_changes) {
+    if(generation > since)
+      region->extend(change);
+  }
+
+  return true;
+}
+
 TextureManager::TextureManager()
-  : m_version {}
+  : m_version {}, m_uploadsPending { false }
 {
 }
 
+TextureManager::~TextureManager()
+{
+  for(TextureCookie *cookie : m_cookies)
+    cookie->m_manager = nullptr;
+}
+
 size_t TextureManager::touch(const Texture &tex)
 {
   const auto [begin, end]
@@ -38,6 +81,19 @@ size_t TextureManager::touch(const Texture &tex)
     it = m_textures.insert(it, tex);
     ++m_version;
   }
+  else if(it->generation != tex.generation) {
+    Texture::Region changes;
+    const bool partial { tex.m_changes &&
+      tex.m_changes(tex.user, tex.scale, it->generation, &changes) };
+    it->generation = tex.generation;
+    ++(it->version);
+    ++m_version;
+
+    if(partial)
+      it->dirty.extend(changes);
+    else
+      it->dirtyBase = it->version, it->dirty = {};
+  }
 
   it->lastTimeActive = now;
 
@@ -60,8 +116,26 @@ void TextureManager::invalidate(void *object)
   const auto [begin, end]
     { equal_range(m_textures.begin(), m_textures.end(), object) };
 
-  for(auto it { begin }; it < end; ++it)
+  for(auto it { begin }; it < end; ++it) {
     ++(it->version);
+    it->dirtyBase = it->version, it->dirty = {};
+  }
+
+  ++m_version;
+}
+
+void TextureManager::invalidate(void *object, const float scale,
+  const Texture::Region &region)
+{
+  const auto [begin, end]
+    { equal_range(m_textures.begin(), m_textures.end(), object) };
+
+  for(auto it { begin }; it < end; ++it) {
+    if(it->scale != scale)
+      continue;
+    ++(it->version);
+    it->dirty.extend(region);
+  }
 
   ++m_version;
 }
@@ -84,7 +158,7 @@ void TextureManager::cleanup()
       continue;
     }
 
-    if(it->lastTimeActive >= cutoff || !it->compact())
+    if((it->lastTimeActive >= cutoff && !it->isStale()) || !it->compact())
       ++it;
     else {
       it = m_textures.erase(it);
@@ -93,7 +167,7 @@ void TextureManager::cleanup()
   }
 }
 
-void TextureManager::update(TextureCookie *cookie, const CommandRunner &runner) const
+void TextureManager::update(TextureCookie *cookie, const CommandRunner &runner)
 {
   // There is no need for it now, but we might eventually want to have this
   // allow selecting only textures of a given scale (eg. if the GDK backend
@@ -104,10 +178,15 @@ void TextureManager::update(TextureCookie *cookie, const CommandRunner &runner)
   if(m_version == cookie->m_version)
     return;
 
+  if(!cookie->m_manager) {
+    cookie->m_manager = this;
+    m_cookies.push_back(cookie);
+  }
+
   cookie->m_version = m_version;
   cookie->m_crumbs.reserve(m_textures.size());
 
-  TextureCmd cmd { this, NullCmd };
+  TextureCmd cmd { this, NullCmd, 0, 0, cookie };
 
   for(size_t i {}, j {}; i < m_textures.size() &&
                          j < cookie->m_crumbs.size(); ++i, ++j) {
@@ -164,13 +243,58 @@ void TextureManager::update(TextureCookie *cookie, const CommandRunner &runner)
     runner(cmd);
     cookie->doCommand(cmd);
   }
+
+  notifyUploaded();
+}
+
+void TextureManager::notifyUploaded()
+{
+  if(!m_uploadsPending)
+    return;
+
+  for(const TextureCookie *cookie : m_cookies) {
+    if(cookie->m_version != m_version)
+      return; // wait for the other renderers to catch up
+  }
+
+  m_uploadsPending = false;
+
+  for(Texture &tex : m_textures) {
+    if(tex.uploaded)
+      continue;
+    tex.uploaded = true;
+    // every renderer is now at the current version
+    tex.dirtyBase = tex.version, tex.dirty = {};
+    if(tex.m_uploaded && tex.isValid())
+      tex.m_uploaded(tex.user, tex.scale);
+  }
+}
+
+bool TextureCmd::updateRegion(const size_t i, Texture::Region *region) const
+{
+  const Texture &tex { (*this)[i] };
+  const TextureCookie::Crumb &crumb { cookie->m_crumbs[offset + i] };
+  if(type != Update || crumb.version < tex.dirtyBase || tex.dirty.empty())
+    return false;
+
+  *region = tex.dirty;
+  return true;
 }
 
 TextureCookie::TextureCookie()
-  : m_version {}
+  : m_manager {}, m_version {}
 {
 }
 
+TextureCookie::~TextureCookie()
+{
+  if(!m_manager)
+    return;
+
+  auto &cookies { m_manager->m_cookies };
+  cookies.erase(std::find(cookies.begin(), cookies.end(), this));
+}
+
 void TextureCookie::doCommand(const TextureCmd &cmd)
 {
   struct MakeCrumb {
@@ -185,16 +309,22 @@ void TextureCookie::doCommand(const TextureCmd &cmd)
   switch(cmd.type) {
   case TextureCmd::Insert: {
     // assumes the manager stores textures contiguously!
-    const Texture *tex { &cmd.manager->get(cmd.offset) };
+    Texture *tex { &m_manager->m_textures[cmd.offset] };
     std::transform(tex, tex + cmd.size, std::inserter(m_crumbs, crumb),
                    MakeCrumb {});
+    for(Texture *end { tex + cmd.size }; tex < end; ++tex)
+      tex->uploaded = false;
+    m_manager->m_uploadsPending = true;
     break;
   }
   case TextureCmd::Update: {
-    auto texture { &cmd.manager->get(cmd.offset) };
+    Texture *texture { &m_manager->m_textures[cmd.offset] };
     const auto end { crumb + cmd.size };
-    while(crumb < end)
+    while(crumb < end) {
+      texture->uploaded = false;
       (crumb++)->version = (texture++)->version;
+    }
+    m_manager->m_uploadsPending = true;
     break;
   }
   case TextureCmd::Remove: {
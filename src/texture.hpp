@@ -18,6 +18,7 @@
 #ifndef REAIMGUI_TEXTURE_HPP
 #define REAIMGUI_TEXTURE_HPP
 
+#include <deque>
 #include <functional>
 #include <vector>
 
@@ -27,33 +28,78 @@ struct TextureCmd;
 
 class Texture {
 public:
+  struct Region {
+    int left, top, right, bottom;
+
+    int width()  const { return right - left; }
+    int height() const { return bottom - top; }
+    bool empty() const { return left >= right || top >= bottom; }
+    void extend(const Region &);
+  };
+
+  // one byte per pixel in Alpha8 and Distance8, to be sampled as white
+  // Distance8 is a signed distance field with the edges at 128
+  enum Format { RGBA8, Alpha8, Distance8 };
+
   using GetPixelsFunc = const unsigned char *(*)(void *object, float scale,
                                                  int *width, int *height);
+  // format of the pixels from GetPixelsFunc, RGBA8 if not set
+  using FormatFunc    = Format(*)(void *object, float scale);
   using CompactFunc   = bool(*)(void *object, float scale);
   using IsValidFunc   = bool(*)(void *object);
+  // every renderer of the manager has a copy of the current pixels
+  using UploadedFunc  = void(*)(void *object, float scale);
+  // whether to remove the texture before it becomes inactive for long enough
+  using IsStaleFunc   = bool(*)(void *object, float scale);
+  // area modified since the given generation, false if unknown
+  using ChangesFunc   = bool(*)(void *object, float scale,
+                                unsigned int since, Region *);
 
   Texture(void *user, float scale, GetPixelsFunc getPixels)
-    : user { user }, scale { scale }, m_getPixels { getPixels },
+    : user { user }, scale { scale }, generation { 0u },
+      m_getPixels { getPixels }, m_format { nullptr },
       m_compact { nullptr }, m_isValid { nullptr },
-      version { 0u }, lastTimeActive { 0.f }
+      m_uploaded { nullptr }, m_isStale { nullptr }, m_changes { nullptr },
+      version { 0u },
+      lastTimeActive { 0.f }, uploaded { true }, dirtyBase { 0u }, dirty {}
   {}
 
   void *user;
   float scale;
+  unsigned int generation; // touching with a new value invalidates the pixels
   GetPixelsFunc m_getPixels;
+  FormatFunc    m_format;
   CompactFunc   m_compact;
   IsValidFunc   m_isValid;
+  UploadedFunc  m_uploaded;
+  IsStaleFunc   m_isStale;
+  ChangesFunc   m_changes;
 
   const unsigned char *getPixels(int *width, int *height) const
   {
     return m_getPixels(user, scale, width, height);
   }
 
+  Format format() const
+  {
+    return m_format ? m_format(user, scale) : RGBA8;
+  }
+
+  static int bytesPerPixel(const Format format)
+  {
+    return format == RGBA8 ? 4 : 1;
+  }
+
   bool isValid() const
   {
     return m_isValid ? m_isValid(user) : true;
   }
 
+  bool isStale() const
+  {
+    return m_isStale ? m_isStale(user, scale) : false;
+  }
+
   bool compact() const
   {
     return m_compact ? m_compact(user, scale) : true;
@@ -65,9 +111,25 @@ public:
 private:
   friend TextureManager;
   friend TextureCookie;
+  friend TextureCmd;
 
   unsigned int version;
   float lastTimeActive;
+  bool uploaded;
+  // renderers having version >= dirtyBase only need to update this area
+  unsigned int dirtyBase;
+  Region dirty;
+};
+
+// area modified by the most recent generations of a texture
+class ChangeHistory {
+public:
+  void add(unsigned int generation, const Texture::Region &);
+  // false if the changes since the given generation are no longer known
+  bool since(unsigned int generation, Texture::Region *) const;
+
+private:
+  std::deque<std::pair<unsigned int, Texture::Region>> m_changes;
 };
 
 class TextureManager {
@@ -75,6 +137,8 @@ public:
   using CommandRunner = std::function<void (const TextureCmd &)>;
 
   TextureManager();
+  TextureManager(const TextureManager &) = delete;
+  ~TextureManager();
 
   size_t touch(const Texture &);
   template<typename... Args>
@@ -82,21 +146,31 @@ public:
   const Texture &get(size_t i) const { return m_textures[i]; }
   void remove(void *object);
   void invalidate(void *object);
+  void invalidate(void *object, float scale, const Texture::Region &);
 
   void cleanup();
-  void update(TextureCookie *, const CommandRunner &) const;
+  void update(TextureCookie *, const CommandRunner &);
 
 private:
+  friend TextureCookie;
+
+  void notifyUploaded();
+
   std::vector<Texture> m_textures;
+  std::vector<TextureCookie *> m_cookies;
   unsigned int m_version;
+  bool m_uploadsPending;
 };
 
 class TextureCookie {
 public:
   TextureCookie();
+  TextureCookie(const TextureCookie &) = delete;
+  ~TextureCookie();
 
 private:
   friend TextureManager;
+  friend TextureCmd;
 
   struct Crumb {
     void *user;
@@ -106,6 +180,7 @@ private:
 
   void doCommand(const TextureCmd &);
 
+  TextureManager *m_manager;
   unsigned int m_version;
   std::vector<Crumb> m_crumbs;
 };
@@ -115,11 +190,15 @@ struct TextureCmd {
   enum Type { Insert, Update, Remove };
   Type type;
   size_t offset, size;
+  const TextureCookie *cookie;
 
   const Texture &operator[](const size_t i) const
   {
     return manager->get(offset + i);
   }
+
+  // area to replace for Update commands, false to upload the whole texture
+  bool updateRegion(size_t i, Texture::Region *) const;
 };
 
 #endif
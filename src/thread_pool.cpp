@@ -0,0 +1,91 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+static std::unique_ptr<ThreadPool> g_pool;
+
+ThreadPool &ThreadPool::get()
+{
+  if(!g_pool) {
+    // leave a core for REAPER's main and audio threads
+    const unsigned int cores { std::thread::hardware_concurrency() };
+    const unsigned int maxThreads { std::clamp(cores / 2, 1u, 4u) };
+    g_pool = std::make_unique<ThreadPool>(maxThreads);
+  }
+
+  return *g_pool;
+}
+
+void ThreadPool::shutdown()
+{
+  // not left to static destructors: joining from DllMain would deadlock
+  g_pool.reset();
+}
+
+ThreadPool::ThreadPool(const unsigned int maxThreads)
+  : m_maxThreads { maxThreads }, m_idleThreads {}, m_stop { false }
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock { m_mutex };
+    m_stop = true;
+    m_queue.clear(); // the plugin is being unloaded
+  }
+
+  m_wakeUp.notify_all();
+
+  for(std::thread &thread : m_threads)
+    thread.join();
+}
+
+void ThreadPool::push(Job &&job)
+{
+  std::lock_guard<std::mutex> lock { m_mutex };
+  m_queue.push_back(std::move(job));
+
+  if(!m_idleThreads && m_threads.size() < m_maxThreads)
+    m_threads.emplace_back(&ThreadPool::work, this);
+  else
+    m_wakeUp.notify_one();
+}
+
+void ThreadPool::work()
+{
+  std::unique_lock<std::mutex> lock { m_mutex };
+
+  while(true) {
+    ++m_idleThreads;
+    m_wakeUp.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+    --m_idleThreads;
+
+    if(m_stop)
+      return;
+
+    Job job { std::move(m_queue.front()) };
+    m_queue.pop_front();
+
+    lock.unlock();
+    job();
+    lock.lock();
+  }
+}
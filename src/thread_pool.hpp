@@ -0,0 +1,61 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAIMGUI_THREAD_POOL_HPP
+#define REAIMGUI_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Bounded pool of worker threads for background jobs (eg. image decoding).
+// Jobs must not throw and must not use ImGui or REAPER APIs.
+//
+// Jobs own their state (their owner only keeps a weak reference) so that an
+// abandoned job can run to completion on its worker without anyone waiting.
+class ThreadPool {
+public:
+  using Job = std::function<void()>;
+
+  // lives until shutdown() so that workers are reused across loads
+  static ThreadPool &get();
+  // joins the workers, to be called when the plugin is unloaded
+  static void shutdown();
+
+  ThreadPool(unsigned int maxThreads);
+  ThreadPool(const ThreadPool &) = delete;
+  ~ThreadPool();
+
+  void push(Job &&);
+
+private:
+  void work();
+
+  const unsigned int m_maxThreads;
+  unsigned int m_idleThreads;
+  bool m_stop;
+  std::mutex m_mutex;
+  std::condition_variable m_wakeUp;
+  std::deque<Job> m_queue;
+  std::vector<std::thread> m_threads;
+};
+
+#endif
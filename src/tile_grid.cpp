@@ -0,0 +1,83 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tile_grid.hpp"
+
+#include <algorithm>
+
+float TileGrid::key(const size_t index)
+{
+  return -static_cast<float>(index + 1);
+}
+
+size_t TileGrid::index(const float key)
+{
+  return static_cast<size_t>(-key) - 1;
+}
+
+TileGrid::TileGrid(const size_t width, const size_t height,
+  const size_t maxResident)
+  : m_width { width }, m_height { height },
+    m_columns { (width  + TILE_SIZE - 1) / TILE_SIZE },
+    m_rows    { (height + TILE_SIZE - 1) / TILE_SIZE },
+    m_maxResident { maxResident }, m_clock {}, m_lastUse(m_columns * m_rows)
+{
+}
+
+TileGrid::Tile TileGrid::tile(const size_t index) const
+{
+  const size_t x { (index % m_columns) * TILE_SIZE },
+               y { (index / m_columns) * TILE_SIZE };
+  return { x, y, std::min(TILE_SIZE, m_width - x),
+                 std::min(TILE_SIZE, m_height - y) };
+}
+
+TileGrid::Tile TileGrid::withBorder(const Tile &core) const
+{
+  const size_t left   { core.x > 0 ? core.x - 1 : 0 },
+               top    { core.y > 0 ? core.y - 1 : 0 },
+               right  { std::min(m_width,  core.right()  + 1) },
+               bottom { std::min(m_height, core.bottom() + 1) };
+  return { left, top, right - left, bottom - top };
+}
+
+bool TileGrid::isResident(const size_t index) const
+{
+  return index < m_lastUse.size() && m_lastUse[index];
+}
+
+std::vector<size_t> TileGrid::evict(const unsigned int keepStamp)
+{
+  size_t resident {};
+  for(const unsigned int lastUse : m_lastUse)
+    resident += lastUse > 0;
+
+  std::vector<size_t> evicted;
+  for(; resident > m_maxResident; --resident) {
+    unsigned int *oldest {};
+    for(unsigned int &lastUse : m_lastUse) {
+      if(lastUse && lastUse < keepStamp && (!oldest || lastUse < *oldest))
+        oldest = &lastUse;
+    }
+    if(!oldest)
+      break; // all drawn by the current call
+    *oldest = 0;
+    evicted.push_back(oldest - m_lastUse.data());
+  }
+
+  return evicted;
+}
@@ -0,0 +1,64 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REAIMGUI_TILE_GRID_HPP
+#define REAIMGUI_TILE_GRID_HPP
+
+#include <cstddef>
+#include <vector>
+
+// Division of an image too large for a single texture into tiles, and which
+// of them are resident (least recently drawn are evicted first).
+class TileGrid {
+public:
+  static constexpr size_t TILE_SIZE { 2048 };
+
+  struct Tile {
+    size_t x, y, width, height;
+
+    size_t right()  const { return x + width;  }
+    size_t bottom() const { return y + height; }
+  };
+
+  // tiles are stored in the texture manager as negative scales
+  static float key(size_t index);
+  static size_t index(float key);
+
+  TileGrid(size_t width, size_t height, size_t maxResident);
+
+  size_t columns() const { return m_columns; }
+  size_t rows()    const { return m_rows;    }
+  size_t count()   const { return m_columns * m_rows; }
+  Tile tile(size_t index) const;
+  // includes a border of neighboring pixels to avoid visible seams
+  // when linear filtering samples past the edge of the tile
+  Tile withBorder(const Tile &) const;
+
+  // tiles used with the same stamp are not evicted by that draw
+  unsigned int nextStamp() { return ++m_clock; }
+  void use(size_t index, unsigned int stamp) { m_lastUse[index] = stamp; }
+  bool isResident(size_t index) const;
+  // returns the tiles that are no longer resident
+  std::vector<size_t> evict(unsigned int keepStamp);
+
+private:
+  size_t m_width, m_height, m_columns, m_rows, m_maxResident;
+  unsigned int m_clock;
+  std::vector<unsigned int> m_lastUse; // 0 = not resident
+};
+
+#endif
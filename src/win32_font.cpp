@@ -73,7 +73,7 @@ static int CALLBACK enumStyles(const LOGFONT *desc,
   return 1;
 }
 
-bool Font::resolve(const char *family, const int style)
+bool Font::resolve(const char *family, const int style, Source *source)
 {
   LOGFONT desc {
     .lfWeight       = style & ReaImGuiFontFlags_Bold ? FW_BOLD : FW_NORMAL,
@@ -92,13 +92,14 @@ bool Font::resolve(const char *family, const int style)
     return false;
   std::vector<unsigned char> fontData(dataSize);
   GetFontData(sel.dc(), 0, 0, fontData.data(), fontData.size());
-  m_data = std::move(fontData);
-  m_index = 0;
+  source->data =
+    std::make_shared<std::vector<unsigned char>>(std::move(fontData));
+  source->index = 0;
 
-  m_missingStyles = style;
+  source->missingStyles = style;
   GetTextFace(sel.dc(), LF_FACESIZE, desc.lfFaceName);
   EnumFontFamiliesEx(sel.dc(), &desc, &enumStyles,
-    reinterpret_cast<LPARAM>(&m_missingStyles), 0);
+    reinterpret_cast<LPARAM>(&source->missingStyles), 0);
 
   return true;
 }
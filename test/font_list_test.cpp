@@ -0,0 +1,25 @@
+#include "../src/error.hpp"
+#include "../src/font.hpp"
+#include "../src/texture.hpp"
+
+#include <gtest/gtest.h>
+#include <imgui/imgui.h>
+
+TEST(FontListTest, UnreadableFont) {
+  ImGuiContext *imgui { ImGui::CreateContext() };
+  ImGui::GetPlatformIO().Monitors.push_back({});
+
+  TextureManager textures;
+  auto font { std::make_unique<Font>("/nonexistent/font.ttf", 13,
+                                     ReaImGuiFontFlags_None) };
+  auto fonts { std::make_unique<FontList>(imgui, &textures) };
+  fonts->add(font.get());
+
+  // the initial build is retried (and reported) at every frame
+  for(int frame {}; frame < 2; ++frame)
+    EXPECT_THROW(fonts->update(), imgui_error);
+
+  fonts.reset();
+  font.reset();
+  ImGui::DestroyContext(imgui);
+}
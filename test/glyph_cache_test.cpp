@@ -0,0 +1,280 @@
+#include "../src/glyph_cache.hpp"
+
+#include <gmock/gmock.h>
+#include <imgui/imgui.h>
+
+TEST(GlyphCacheTest, Requests) {
+  GlyphRequests &requests { GlyphRequests::get() };
+  const auto &list { requests.list() };
+  const size_t size { list.size() };
+
+  GlyphRequests::add(nullptr);
+  GlyphRequests::add("plain ASCII text");
+  EXPECT_EQ(list.size(), size);
+
+  GlyphRequests::add("\xe2\x86\x92 d\xc3\xa9j\xc3\xa0 \xe2\x86\x92");
+  ASSERT_EQ(list.size(), size + 3);
+  EXPECT_THAT(std::vector<unsigned int>(list.begin() + size, list.end()),
+    testing::ElementsAre(0x2192, 0xE9, 0xE0));
+  EXPECT_TRUE(requests.isRecent(0xE9));
+  EXPECT_FALSE(requests.isRecent('d'));
+}
+
+TEST(GlyphCacheTest, ASCIISubsetRequests) {
+  GlyphRequests &requests { GlyphRequests::get() };
+  const auto &list { requests.list() };
+  const size_t size { list.size() };
+
+  GlyphRequests::ASCIISet missing;
+  missing['1'] = missing['2'] = true;
+  requests.addASCIISubset(missing);
+  GlyphRequests::add(nullptr);
+  GlyphRequests::add("3 1\t2"); // '3' is in the subset
+  requests.removeASCIISubset(missing);
+  GlyphRequests::add("1");
+
+  EXPECT_THAT(std::vector<unsigned int>(list.begin() + size, list.end()),
+    testing::ElementsAre('1', '2'));
+}
+
+static constexpr unsigned int MISSING { 0xFFFF };
+
+class FakeRasterizer : public GlyphRasterizer {
+public:
+  FakeRasterizer(const int width, const int height, const bool colored)
+    : m_width { width }, m_height { height }, m_colored { colored } {}
+
+  void verticalMetrics(float *ascent, float *descent) const override
+  {
+    *ascent = 10.f, *descent = -3.f;
+  }
+
+  bool render(const unsigned int codepoint, Metrics *metrics) override
+  {
+    if(codepoint == MISSING)
+      return false;
+    *metrics = { m_width, m_height, 1, -m_height, m_width + 2.f, m_colored };
+    return true;
+  }
+
+  void copyTo(unsigned char *pixels, const size_t stride,
+    const bool alphaOnly) const override
+  {
+    constexpr unsigned char rgba[] { 0x10, 0x20, 0x30, 0x80 };
+    for(int y {}; y < m_height; ++y) {
+      unsigned char *dst { pixels + (y * stride) };
+      for(int x {}; x < m_width; ++x) {
+        if(alphaOnly)
+          *dst++ = 0x80;
+        else
+          dst = std::copy(std::begin(rgba), std::end(rgba), dst);
+      }
+    }
+  }
+
+private:
+  int m_width, m_height;
+  bool m_colored;
+};
+
+static GlyphRasterizer::Factory fakeFactory(const int width, const int height,
+  const bool colored = false)
+{
+  return [=] { return std::make_unique<FakeRasterizer>(width, height, colored); };
+}
+
+static void buildAtlas(ImFontAtlas *atlas)
+{
+  atlas->AddFontDefault();
+  atlas->Build();
+}
+
+TEST(GlyphCacheTest, AllocateGlyphs) {
+  ImFontAtlas atlas;
+  buildAtlas(&atlas);
+  float bottom { atlas.TexUvWhitePixel.y };
+  for(const ImFontGlyph &glyph : atlas.Fonts[0]->Glyphs)
+    bottom = std::max(bottom, glyph.V1);
+
+  DynamicGlyphs glyphs { &atlas };
+  EXPECT_EQ(glyphs.format(), Texture::Alpha8);
+  ASSERT_NE(atlas.TexPixelsAlpha8, nullptr);
+  EXPECT_EQ(atlas.TexPixelsRGBA32, nullptr);
+
+  ImFont *font { glyphs.createFont(fakeFactory(8, 10), 13.f) };
+  ASSERT_NE(font, nullptr);
+  EXPECT_EQ(font->Ascent, 10.f);
+  EXPECT_EQ(font->Descent, -3.f);
+
+  Texture::Region region {};
+  EXPECT_EQ(glyphs.add({ 'a', MISSING, 'b' }, 0, false, &region),
+            DynamicGlyphs::Done);
+  EXPECT_EQ(font->FindGlyphNoFallback(MISSING), nullptr);
+  const ImFontGlyph *a { font->FindGlyphNoFallback('a') },
+                    *b { font->FindGlyphNoFallback('b') };
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(a->X0, 1.f);
+  EXPECT_EQ(a->Y0, 0.f); // offsetY + ascent
+  EXPECT_EQ(a->AdvanceX, 10.f);
+
+  // on the same shelf, below the glyphs built upfront
+  const int width { atlas.TexWidth }, height { atlas.TexHeight };
+  const int ax { static_cast<int>(a->U0 * width) },
+            ay { static_cast<int>((a->V0 * height) + .5f) },
+            bx { static_cast<int>(b->U0 * width) };
+  EXPECT_GT(a->V0, bottom);
+  EXPECT_FLOAT_EQ(a->V0, b->V0);
+  EXPECT_FLOAT_EQ(a->V1 - a->V0, 10.f / height);
+  EXPECT_EQ(bx, ax + 8 + atlas.TexGlyphPadding);
+  EXPECT_EQ(region.left, ax);
+  EXPECT_EQ(region.top, ay);
+  EXPECT_EQ(region.right, bx + 8);
+  EXPECT_EQ(region.bottom, ay + 10);
+
+  const unsigned char *pixels { atlas.TexPixelsAlpha8 };
+  EXPECT_EQ(pixels[(ay * width) + ax], 0x80);
+  EXPECT_EQ(pixels[((ay + 9) * width) + ax + 7], 0x80);
+  EXPECT_EQ(pixels[(ay * width) + ax + 8], 0); // padding
+  EXPECT_EQ(pixels[((ay + 10) * width) + ax], 0);
+}
+
+TEST(GlyphCacheTest, SkipOversizedGlyphs) {
+  ImFontAtlas atlas;
+  buildAtlas(&atlas);
+  DynamicGlyphs glyphs { &atlas };
+  ImFont *font { glyphs.createFont(fakeFactory(atlas.TexWidth, 8), 13.f) };
+  ASSERT_NE(font, nullptr);
+
+  Texture::Region region {};
+  EXPECT_EQ(glyphs.add({ 'a' }, 0, true, &region), DynamicGlyphs::Done);
+  EXPECT_EQ(font->FindGlyphNoFallback('a'), nullptr);
+  EXPECT_TRUE(region.empty());
+}
+
+TEST(GlyphCacheTest, GrowAtlas) {
+  ImFontAtlas atlas;
+  buildAtlas(&atlas);
+  DynamicGlyphs glyphs { &atlas };
+  const int width { atlas.TexWidth }, height { atlas.TexHeight };
+  const float whitePixel { atlas.TexUvWhitePixel.y },
+              builtV1 { atlas.Fonts[0]->Glyphs[0].V1 };
+  ImFont *font { glyphs.createFont(fakeFactory(8, height - 1), 13.f) };
+  ASSERT_NE(font, nullptr);
+
+  // other users still need the old texture coordinates
+  Texture::Region region {};
+  EXPECT_EQ(glyphs.add({ 'a' }, 0, false, &region), DynamicGlyphs::Postponed);
+  EXPECT_EQ(font->FindGlyphNoFallback('a'), nullptr);
+  EXPECT_EQ(atlas.TexHeight, height);
+  EXPECT_TRUE(region.empty());
+
+  EXPECT_EQ(glyphs.add({ 'a' }, 0, true, &region), DynamicGlyphs::Done);
+  EXPECT_EQ(atlas.TexHeight, height * 2);
+  EXPECT_FLOAT_EQ(atlas.TexUvScale.y, .5f / height);
+  EXPECT_FLOAT_EQ(atlas.TexUvWhitePixel.y, whitePixel / 2);
+  EXPECT_FLOAT_EQ(atlas.Fonts[0]->Glyphs[0].V1, builtV1 / 2);
+  const ImFontGlyph *a { font->FindGlyphNoFallback('a') };
+  ASSERT_NE(a, nullptr);
+  EXPECT_FLOAT_EQ(a->V1 - a->V0, (height - 1.f) / (height * 2));
+  EXPECT_EQ(region.left, 0);
+  EXPECT_EQ(region.top, 0);
+  EXPECT_EQ(region.right, width);
+  EXPECT_EQ(region.bottom, height * 2);
+}
+
+TEST(GlyphCacheTest, AtlasFull) {
+  ImFontAtlas atlas;
+  buildAtlas(&atlas);
+  DynamicGlyphs glyphs { &atlas };
+  ImFont *font { glyphs.createFont(fakeFactory(8, 4096), 13.f) };
+  ASSERT_NE(font, nullptr);
+
+  Texture::Region region {};
+  EXPECT_EQ(glyphs.add({ 'a', 'b' }, 0, true, &region), DynamicGlyphs::Full);
+  EXPECT_EQ(font->FindGlyphNoFallback('a'), nullptr);
+  EXPECT_LE(atlas.TexHeight, 4096);
+}
+
+TEST(GlyphCacheTest, ColoredGlyphs) {
+  ImFontAtlas atlas;
+  buildAtlas(&atlas);
+  DynamicGlyphs glyphs { &atlas };
+  const int width { atlas.TexWidth }, height { atlas.TexHeight };
+  const size_t whitePixel
+    { (static_cast<size_t>(atlas.TexUvWhitePixel.y * height) * width) +
+      static_cast<size_t>(atlas.TexUvWhitePixel.x * width) };
+  const unsigned char whiteAlpha { atlas.TexPixelsAlpha8[whitePixel] };
+  ImFont *font { glyphs.createFont(fakeFactory(4, 4, true), 13.f) };
+  ASSERT_NE(font, nullptr);
+
+  Texture::Region region {};
+  EXPECT_EQ(glyphs.add({ 'a' }, 0, false, &region), DynamicGlyphs::Done);
+  EXPECT_EQ(glyphs.format(), Texture::RGBA8);
+  EXPECT_EQ(atlas.TexPixelsAlpha8, nullptr);
+  ASSERT_NE(atlas.TexPixelsRGBA32, nullptr);
+  EXPECT_EQ(region.left, 0);
+  EXPECT_EQ(region.top, 0);
+  EXPECT_EQ(region.right, width);
+  EXPECT_EQ(region.bottom, height);
+
+  const auto *pixels
+    { reinterpret_cast<const unsigned char *>(atlas.TexPixelsRGBA32) };
+  EXPECT_THAT(std::vector<unsigned char>
+      (&pixels[whitePixel * 4], &pixels[(whitePixel + 1) * 4]),
+    testing::ElementsAre(0xFF, 0xFF, 0xFF, whiteAlpha));
+
+  const ImFontGlyph *a { font->FindGlyphNoFallback('a') };
+  ASSERT_NE(a, nullptr);
+  EXPECT_TRUE(a->Colored);
+  const size_t glyphPixel
+    { (static_cast<size_t>((a->V0 * height) + .5f) * width) +
+      static_cast<size_t>(a->U0 * width) };
+  EXPECT_THAT(std::vector<unsigned char>
+      (&pixels[glyphPixel * 4], &pixels[(glyphPixel + 1) * 4]),
+    testing::ElementsAre(0x10, 0x20, 0x30, 0x80));
+}
+
+TEST(GlyphCacheTest, DistanceFieldFormat) {
+  ImFontAtlas atlas;
+  buildAtlas(&atlas);
+  DynamicGlyphs glyphs { &atlas, true };
+  EXPECT_EQ(glyphs.format(), Texture::Distance8);
+  EXPECT_EQ(atlas.TexPixelsRGBA32, nullptr);
+}
+
+TEST(GlyphCacheTest, AtlasPages) {
+  AtlasPages layout { 100, 30 };
+  layout.add(0, false, 50);
+  layout.add(1, false, 30);  // would exceed the first page
+  layout.add(2, true,  10);  // distance fields are kept apart
+  layout.add(3, false, 200); // larger than a page on its own
+  layout.add(4, true,  20);
+
+  const auto &pages { layout.pages() };
+  ASSERT_EQ(pages.size(), 4);
+  EXPECT_FALSE(pages[0].distanceField);
+  EXPECT_EQ(pages[0].area, 80);
+  EXPECT_THAT(pages[0].fonts, testing::ElementsAre(0));
+  EXPECT_FALSE(pages[1].distanceField);
+  EXPECT_THAT(pages[1].fonts, testing::ElementsAre(1));
+  EXPECT_TRUE(pages[2].distanceField);
+  EXPECT_EQ(pages[2].area, 30);
+  EXPECT_THAT(pages[2].fonts, testing::ElementsAre(2, 4));
+  EXPECT_FALSE(pages[3].distanceField);
+  EXPECT_THAT(pages[3].fonts, testing::ElementsAre(3));
+}
+
+TEST(GlyphCacheTest, AtlasPagesOversizedFirstFont) {
+  AtlasPages layout { 100, 30 };
+  layout.add(0, false, 500);
+  ASSERT_EQ(layout.pages().size(), 1);
+  EXPECT_THAT(layout.pages()[0].fonts, testing::ElementsAre(0));
+}
+
+TEST(GlyphCacheTest, DistanceFieldPageWidth) {
+  EXPECT_EQ(AtlasPages::distanceFieldWidth(0), 512);
+  EXPECT_EQ(AtlasPages::distanceFieldWidth(512 * 512), 512);
+  EXPECT_EQ(AtlasPages::distanceFieldWidth((512 * 512) + 1), 1024);
+  EXPECT_EQ(AtlasPages::distanceFieldWidth(size_t { 1 } << 30), 4096);
+}
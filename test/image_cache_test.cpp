@@ -0,0 +1,110 @@
+#include "../src/image_cache.hpp"
+
+#include <gtest/gtest.h>
+
+static ImageCache::Key key(const char *path)
+{
+  return { path, 42, 1234, 0, 0 };
+}
+
+static ImageCache::Entry entry(const size_t bytes)
+{
+  return { std::make_shared<ImageCache::Pixels>(bytes), bytes / 4, 1 };
+}
+
+TEST(ImageCacheTest, Find) {
+  ImageCache cache { 1024 };
+  ImageCache::Entry found;
+  EXPECT_FALSE(cache.find(key("a"), &found));
+
+  const ImageCache::Entry a { entry(16) };
+  cache.insert(key("a"), a);
+  ASSERT_TRUE(cache.find(key("a"), &found));
+  EXPECT_EQ(found.pixels, a.pixels);
+  EXPECT_EQ(found.width, 4);
+  EXPECT_EQ(cache.size(), 16);
+}
+
+TEST(ImageCacheTest, KeyIncludesMetadata) {
+  ImageCache cache { 1024 };
+  cache.insert(key("a"), entry(16));
+
+  ImageCache::Key modified { key("a") };
+  modified.modified += 1;
+  ImageCache::Key resized { key("a") };
+  resized.maxWidth = 8;
+
+  ImageCache::Entry found;
+  EXPECT_FALSE(cache.find(modified, &found));
+  EXPECT_FALSE(cache.find(resized, &found));
+}
+
+TEST(ImageCacheTest, EvictLeastRecentlyUsed) {
+  ImageCache cache { 32 };
+  cache.insert(key("a"), entry(16));
+  cache.insert(key("b"), entry(16));
+
+  ImageCache::Entry found;
+  ASSERT_TRUE(cache.find(key("a"), &found));
+  found = {};
+
+  cache.insert(key("c"), entry(16));
+  EXPECT_EQ(cache.size(), 32);
+  EXPECT_TRUE(cache.find(key("a"), &found));
+  EXPECT_FALSE(cache.find(key("b"), &found));
+  EXPECT_TRUE(cache.find(key("c"), &found));
+}
+
+TEST(ImageCacheTest, KeepUsedPixels) {
+  ImageCache cache { 16 };
+  const ImageCache::Entry a { entry(16) };
+  cache.insert(key("a"), a);
+  cache.insert(key("b"), entry(16));
+
+  ImageCache::Entry found;
+  EXPECT_TRUE(cache.find(key("a"), &found));
+  EXPECT_FALSE(cache.find(key("b"), &found));
+}
+
+TEST(ImageCacheTest, EvictReleasedPixels) {
+  ImageCache cache { 16 };
+  ImageCache::Entry a { entry(16) }, b { entry(16) };
+  cache.insert(key("a"), a);
+  cache.insert(key("b"), b);
+  EXPECT_EQ(cache.size(), 32); // both are in use
+
+  a = {};
+  cache.evict();
+  EXPECT_EQ(cache.size(), 16);
+
+  ImageCache::Entry found;
+  EXPECT_FALSE(cache.find(key("a"), &found));
+  EXPECT_TRUE(cache.find(key("b"), &found));
+}
+
+TEST(ImageCacheTest, Release) {
+  ImageCache cache { 1024 };
+  ImageCache::Entry a { entry(16) }, b { entry(16) };
+  cache.insert(key("a"), a);
+  cache.insert(key("b"), b);
+
+  ImageCache::Entry shared { b }; // b's pixels are used by another image
+  cache.release(std::move(a.pixels));
+  cache.release(std::move(b.pixels));
+  EXPECT_EQ(cache.size(), 16);
+
+  ImageCache::Entry found;
+  EXPECT_FALSE(cache.find(key("a"), &found));
+  EXPECT_TRUE(cache.find(key("b"), &found));
+}
+
+TEST(ImageCacheTest, UnusedSize) {
+  ImageCache cache { 1024 };
+  ImageCache::Entry a { entry(16) };
+  cache.insert(key("a"), a);
+  cache.insert(key("b"), entry(8));
+  EXPECT_EQ(cache.unusedSize(), 8);
+
+  a = {};
+  EXPECT_EQ(cache.unusedSize(), 24);
+}
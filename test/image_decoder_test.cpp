@@ -0,0 +1,130 @@
+#include "../src/error.hpp"
+#include "../src/image.hpp"
+#include "../src/image_formats.hpp"
+
+#include <cstring>
+#include <gtest/gtest.h>
+
+using Bytes = std::vector<unsigned char>;
+
+static Bytes decode(const Bytes &file, size_t *width, size_t *height)
+{
+  auto decoder { Image::createDecoder(file.data(), file.size()) };
+  *width  = decoder->width();
+  *height = decoder->height();
+
+  Bytes pixels;
+  decoder->decode(pixels);
+  return pixels;
+}
+
+static Bytes header(const unsigned char *magic, const size_t magicSize,
+  const uint32_t width, const uint32_t height)
+{
+  Bytes file(magic, magic + magicSize);
+  file.resize(magicSize + 8);
+  writeBigEndian32(&file[magicSize],     width);
+  writeBigEndian32(&file[magicSize + 4], height);
+  return file;
+}
+
+static Bytes qoi(const uint32_t width, const uint32_t height, const Bytes &ops)
+{
+  Bytes file { header(QOI::MAGIC, sizeof(QOI::MAGIC), width, height) };
+  file.push_back(4); // channels
+  file.push_back(0); // colorspace
+  file.insert(file.end(), ops.begin(), ops.end());
+  file.insert(file.end(), std::begin(QOI::END_MARKER), std::end(QOI::END_MARKER));
+  return file;
+}
+
+TEST(ImageDecoderTest, QOI) {
+  const Bytes file { qoi(2, 2, {
+    QOI::OP_RGBA, 10, 20, 30, 255,
+    QOI::OP_DIFF | 3 << 4 | 2 << 2 | 1, // r+1 g+0 b-1
+    QOI::OP_INDEX | QOI::hash(Bytes { 10, 20, 30, 255 }.data()),
+    QOI::OP_RUN | 0,
+  }) };
+
+  size_t width, height;
+  const Bytes pixels { decode(file, &width, &height) };
+  EXPECT_EQ(width, 2);
+  EXPECT_EQ(height, 2);
+  EXPECT_EQ(pixels, (Bytes {
+    10, 20, 30, 255,  11, 20, 29, 255,
+    10, 20, 30, 255,  10, 20, 30, 255,
+  }));
+}
+
+TEST(ImageDecoderTest, TruncatedQOI) {
+  Bytes file { qoi(2, 2, { QOI::OP_RUN | 3 }) };
+  file.resize(QOI::HEADER_SIZE);
+
+  size_t width, height;
+  EXPECT_THROW(decode(file, &width, &height), reascript_error);
+}
+
+TEST(ImageDecoderTest, RawRGBA) {
+  Bytes file { header(RawRGBA::MAGIC, sizeof(RawRGBA::MAGIC), 1, 2) };
+  const Bytes rows { 1, 2, 3, 4,  5, 6, 7, 8 };
+  file.insert(file.end(), rows.begin(), rows.end());
+
+  size_t width, height;
+  EXPECT_EQ(decode(file, &width, &height), rows);
+  EXPECT_EQ(width, 1);
+  EXPECT_EQ(height, 2);
+
+  file.pop_back();
+  EXPECT_THROW(decode(file, &width, &height), reascript_error);
+}
+
+TEST(ImageDecoderTest, DecodeRows) {
+  Bytes file { header(RawRGBA::MAGIC, sizeof(RawRGBA::MAGIC), 1, 3) };
+  file.insert(file.end(), { 1, 2, 3, 4,  5, 6, 7, 8,  9, 10, 11, 12 });
+
+  auto decoder { Image::createDecoder(file.data(), file.size()) };
+  std::vector<size_t> rows;
+  decoder->decodeRows([&](const size_t y, const unsigned char *row) {
+    EXPECT_EQ(row[0], (y * 4) + 1);
+    rows.push_back(y);
+    return y < 1; // stop after the second row
+  });
+  EXPECT_EQ(rows, (std::vector<size_t> { 0, 1 }));
+}
+
+TEST(ImageDecoderTest, ResizeTo) {
+  Bytes file { header(RawRGBA::MAGIC, sizeof(RawRGBA::MAGIC), 2, 2) };
+  file.insert(file.end(), {
+    0,   0,   0,   255,  100, 100, 100, 255,
+    200, 200, 200, 255,  100, 100, 100, 255,
+  });
+
+  auto decoder { Image::createDecoder(file.data(), file.size()) };
+  decoder->resizeTo(1, 1);
+  EXPECT_EQ(decoder->width(), 1);
+  EXPECT_EQ(decoder->height(), 1);
+
+  size_t rows {};
+  decoder->decodeRows([&](size_t, const unsigned char *row) {
+    EXPECT_EQ(Bytes(row, row + 4), (Bytes { 100, 100, 100, 255 }));
+    ++rows;
+    return true;
+  });
+  EXPECT_EQ(rows, 1);
+
+  decoder = Image::createDecoder(file.data(), file.size());
+  decoder->resizeTo(1, 1);
+  Bytes pixels;
+  size_t progress {};
+  decoder->decode(pixels, [&](const size_t rows) { progress = rows; });
+  EXPECT_EQ(pixels, (Bytes { 100, 100, 100, 255 }));
+  EXPECT_EQ(progress, 1);
+}
+
+TEST(ImageDecoderTest, BigEndian32) {
+  unsigned char bytes[4];
+  writeBigEndian32(bytes, 0xF1E2D3C4);
+  EXPECT_EQ(bytes[0], 0xF1);
+  EXPECT_EQ(bytes[3], 0xC4);
+  EXPECT_EQ(readBigEndian32(bytes), 0xF1E2D3C4);
+}
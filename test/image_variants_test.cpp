@@ -0,0 +1,117 @@
+#include "../src/image_variants.hpp"
+
+#include <gtest/gtest.h>
+
+static int a, b; // sources
+
+TEST(ImageVariantsTest, Tolerance) {
+  EXPECT_FALSE(ImageVariants::isNeeded(1.f, 1.f));
+  EXPECT_FALSE(ImageVariants::isNeeded(1.f, 1.04f));
+  EXPECT_FALSE(ImageVariants::isNeeded(2.f, 1.91f));
+  EXPECT_TRUE(ImageVariants::isNeeded(1.f, 1.06f));
+  EXPECT_TRUE(ImageVariants::isNeeded(2.f, 1.89f));
+  EXPECT_TRUE(ImageVariants::isNeeded(2.f, 1.5f));
+}
+
+TEST(ImageVariantsTest, Find) {
+  ImageVariants::Budget budget { 1024 };
+  ImageVariants variants { budget };
+  EXPECT_EQ(variants.find(1.5f), nullptr);
+
+  ImageVariants::Variant &variant { variants.update(1.5f, &a, 3, 2, 0) };
+  EXPECT_EQ(variant.source, &a);
+  EXPECT_EQ(variant.width, 3);
+  EXPECT_EQ(variant.height, 2);
+  EXPECT_EQ(variants.find(1.5f), &variant);
+  EXPECT_EQ(variants.find(1.25f), nullptr);
+  EXPECT_EQ(&variants.update(1.5f, &a, 3, 2, 0), &variant);
+  EXPECT_EQ(variants.count(), 1);
+}
+
+TEST(ImageVariantsTest, UpdateInvalidates) {
+  ImageVariants::Budget budget { 1024 };
+  ImageVariants variants { budget };
+
+  ImageVariants::Variant *variant { &variants.update(1.5f, &a, 3, 2, 0) };
+  variants.allocate(*variant);
+  EXPECT_EQ(variant->pixels.size(), 3 * 2 * 4);
+  EXPECT_EQ(budget.size(), 3 * 2 * 4);
+  const unsigned int generation { variant->generation };
+
+  variant = &variants.update(1.5f, &a, 3, 2, 0);
+  EXPECT_EQ(variant->generation, generation);
+  EXPECT_FALSE(variant->pixels.empty());
+
+  variant = &variants.update(1.5f, &a, 3, 2, 1); // source modified
+  EXPECT_GT(variant->generation, generation);
+  EXPECT_TRUE(variant->pixels.empty());
+  EXPECT_EQ(budget.size(), 0);
+
+  variants.allocate(*variant);
+  variant = &variants.update(1.5f, &b, 3, 2, 1);
+  EXPECT_EQ(variant->source, &b);
+  EXPECT_TRUE(variant->pixels.empty());
+  EXPECT_EQ(budget.size(), 0);
+}
+
+TEST(ImageVariantsTest, Remove) {
+  ImageVariants::Budget budget { 1024 };
+  ImageVariants variants { budget };
+  variants.allocate(variants.update(1.5f, &a, 3, 2, 0));
+  variants.allocate(variants.update(0.5f, &a, 1, 1, 0));
+  EXPECT_EQ(budget.size(), (3 * 2 * 4) + 4);
+
+  variants.remove(1.5f);
+  EXPECT_EQ(variants.find(1.5f), nullptr);
+  ASSERT_NE(variants.find(0.5f), nullptr);
+  EXPECT_EQ(variants.count(), 1);
+  EXPECT_EQ(budget.size(), 4);
+
+  variants.remove(1.5f); // no-op
+  EXPECT_EQ(variants.count(), 1);
+}
+
+TEST(ImageVariantsTest, ReleaseOverBudget) {
+  ImageVariants::Budget budget { 32 };
+  ImageVariants variants { budget };
+
+  ImageVariants::Variant &small { variants.update(0.5f, &a, 2, 2, 0) };
+  variants.allocate(small);
+  EXPECT_FALSE(budget.exceeded());
+  EXPECT_FALSE(variants.uploaded(0.5f)); // kept within the budget
+  EXPECT_EQ(small.pixels.size(), 16);
+
+  ImageVariants::Variant &large { variants.update(1.5f, &a, 3, 2, 0) };
+  variants.allocate(large);
+  EXPECT_TRUE(budget.exceeded());
+  EXPECT_TRUE(variants.uploaded(1.5f));
+  EXPECT_TRUE(large.pixels.empty());
+  EXPECT_EQ(budget.size(), 16);
+  EXPECT_FALSE(variants.uploaded(1.5f));
+}
+
+TEST(ImageVariantsTest, SharedBudget) {
+  ImageVariants::Budget budget { 32 };
+  {
+    ImageVariants set1 { budget }, set2 { budget };
+    set1.allocate(set1.update(1.5f, &a, 2, 2, 0));
+    set2.allocate(set2.update(1.5f, &b, 2, 2, 0));
+    EXPECT_EQ(budget.size(), 32);
+    EXPECT_FALSE(budget.exceeded());
+
+    set2.allocate(set2.update(0.5f, &b, 1, 1, 0));
+    EXPECT_TRUE(budget.exceeded());
+    EXPECT_TRUE(set1.uploaded(1.5f));
+    EXPECT_EQ(budget.size(), 20);
+  }
+  EXPECT_EQ(budget.size(), 0);
+}
+
+TEST(ImageVariantsTest, DefaultBudget) {
+  // 32 MiB, exactly one 4096x2048 variant
+  ImageVariants variants;
+  variants.allocate(variants.update(1.f, &a, 4096, 2048, 0));
+  EXPECT_FALSE(ImageVariants::budget().exceeded());
+  variants.allocate(variants.update(2.f, &a, 1, 1, 0));
+  EXPECT_TRUE(ImageVariants::budget().exceeded());
+}
@@ -0,0 +1,74 @@
+#include "../src/resample.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+TEST(ResampleTest, Fit) {
+  size_t w { 400 }, h { 200 };
+  Resample::fit(&w, &h, 100, 0);
+  EXPECT_EQ(w, 100);
+  EXPECT_EQ(h, 50);
+
+  w = 400, h = 200;
+  Resample::fit(&w, &h, 100, 20);
+  EXPECT_EQ(w, 40);
+  EXPECT_EQ(h, 20);
+
+  w = 400, h = 200;
+  Resample::fit(&w, &h, 800, 800); // no upscaling
+  EXPECT_EQ(w, 400);
+  EXPECT_EQ(h, 200);
+
+  w = 400, h = 200;
+  Resample::fit(&w, &h, 0, 0);
+  EXPECT_EQ(w, 400);
+  EXPECT_EQ(h, 200);
+}
+
+TEST(ResampleTest, Average) {
+  const std::array<unsigned char, 4 * 4> src {
+    0,   0,   0,   255,  100, 100, 100, 255,
+    200, 200, 200, 255,  100, 100, 100, 255,
+  };
+  std::array<unsigned char, 4> dst;
+  Resample::downscale(src.data(), 2, 2, dst.data(), 1, 1);
+  EXPECT_EQ(dst, (std::array<unsigned char, 4> { 100, 100, 100, 255 }));
+}
+
+TEST(ResampleTest, FractionalCoverage) {
+  const std::array<unsigned char, 3 * 4> src {
+    0, 0, 0, 255,  90, 90, 90, 255,  180, 180, 180, 255,
+  };
+  std::array<unsigned char, 2 * 4> dst;
+  Resample::downscale(src.data(), 3, 1, dst.data(), 2, 1);
+  // each destination pixel covers 1.5 source pixels
+  EXPECT_EQ(dst, (std::array<unsigned char, 2 * 4> {
+    30, 30, 30, 255,  150, 150, 150, 255,
+  }));
+}
+
+TEST(ResampleTest, TransparentDoesNotBleed) {
+  const std::array<unsigned char, 2 * 4> src {
+    255, 0, 0, 255,  0, 255, 0, 0,
+  };
+  std::array<unsigned char, 4> dst;
+  Resample::downscale(src.data(), 2, 1, dst.data(), 1, 1);
+  EXPECT_EQ(dst, (std::array<unsigned char, 4> { 255, 0, 0, 128 }));
+}
+
+TEST(ResampleTest, ReducerRows) {
+  const std::array<unsigned char, 3 * 4> src {
+    0, 0, 0, 255,  90, 90, 90, 255,  180, 180, 180, 255,
+  };
+  Resample::Reducer reducer { 1, 3, 1, 2 };
+  EXPECT_EQ(reducer.push(&src[0]), nullptr);
+
+  const unsigned char *row { reducer.push(&src[4]) };
+  ASSERT_NE(row, nullptr);
+  EXPECT_EQ(row[0], 30);
+
+  row = reducer.push(&src[8]);
+  ASSERT_NE(row, nullptr);
+  EXPECT_EQ(row[0], 150);
+}
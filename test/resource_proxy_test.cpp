@@ -2,7 +2,8 @@
 
 #include <gtest/gtest.h>
 
-struct MyResource : Resource {
+struct MyResource
+  : TypedResource<MyResource, Resource, ResourceSubclass_Test2> {
   bool attachable(const Context *) const override { return false; }
   bool isValid() const override { return valid; }
 
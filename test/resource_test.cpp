@@ -2,14 +2,18 @@
 
 #include <gtest/gtest.h>
 
-struct Foo : Resource {
+enum FooSubclass : uint8_t {
+  FooSubclass_Bar = 1,
+};
+
+struct Foo : TypedResource<Foo, Resource, ResourceSubclass_Test1> {
   bool attachable(const Context *) const override { return false; }
   bool isValid() const override { return valid; }
 
   bool valid { true };
 };
 
-struct Bar : Foo {};
+struct Bar : TypedResource<Bar, Foo, FooSubclass_Bar> {};
 
 TEST(ResourceTest, ValidateNull) {
   auto foo { std::make_unique<Foo>() };
@@ -54,3 +58,29 @@ TEST(ResourceTest, ValidateVoid) {
   foo->valid = false;
   EXPECT_FALSE(Resource::isValid<void>(foo.get()));
 }
+
+TEST(ResourceTest, ValidateReusedSlot) {
+  // destroyed without freeing its memory, so that the next resource
+  // reuses the slot of foo but not its address
+  alignas(Foo) unsigned char storage[sizeof(Foo)];
+  Foo *foo { new(storage) Foo };
+  auto bar { std::make_unique<Foo>() };
+  foo->~Foo();
+  auto baz { std::make_unique<Bar>() };
+  ASSERT_NE(static_cast<Foo *>(baz.get()), foo);
+  EXPECT_FALSE(Resource::isValid<Foo>(foo));
+  EXPECT_TRUE(Resource::isValid<Foo>(bar.get()));
+  EXPECT_TRUE(Resource::isValid<Bar>(baz.get()));
+}
+
+TEST(ResourceTest, CountLive) {
+  size_t before, live, collected;
+  Resource::stats(&before, &collected);
+  auto foo { std::make_unique<Foo>() };
+  Resource::stats(&live, &collected);
+  EXPECT_EQ(live, before + 1);
+  foo.reset();
+  Resource::stats(&live, &collected);
+  EXPECT_EQ(live, before);
+  EXPECT_EQ(collected, 0); // not destroyed by the timer
+}
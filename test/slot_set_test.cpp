@@ -0,0 +1,41 @@
+#include "../src/slot_set.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(SlotSetTest, InsertErase) {
+  int a, b;
+  SlotSet<int *> set;
+  EXPECT_TRUE(set.empty());
+  set.insert(&a);
+  set.insert(&b);
+  EXPECT_EQ(set.size(), 2);
+  EXPECT_TRUE(set.contains(&a));
+
+  set.erase(&a);
+  set.erase(&a); // not found
+  EXPECT_EQ(set.size(), 1);
+  EXPECT_FALSE(set.contains(&a));
+  EXPECT_TRUE(set.contains(&b));
+}
+
+TEST(SlotSetTest, StableSlots) {
+  int a, b, c;
+  SlotSet<int *> set;
+  set.insert(&a);
+  set.insert(&b);
+  set.erase(&a);
+  ASSERT_EQ(set.slots(), 2);
+  EXPECT_EQ(set[0], nullptr);
+  EXPECT_EQ(set[1], &b);
+
+  set.insert(&c); // in the slot freed by a
+  ASSERT_EQ(set.slots(), 2);
+  EXPECT_EQ(set[0], &c);
+  EXPECT_EQ(set[1], &b);
+  EXPECT_FALSE(set.contains(&a));
+
+  set.erase(&b);
+  set.insert(&a);
+  EXPECT_EQ(set[1], &a);
+  EXPECT_TRUE(set.contains(&a));
+}
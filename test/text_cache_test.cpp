@@ -0,0 +1,60 @@
+#include "../src/text_cache.hpp"
+
+#include <gtest/gtest.h>
+
+static TextCache::Key key(const char *text, const float wrapWidth = -1.f)
+{
+  return { nullptr, 13.f, wrapWidth, false, text };
+}
+
+TEST(TextCacheTest, Find) {
+  TextCache cache { 8 };
+  TextCache::Size size;
+  EXPECT_FALSE(cache.find(key("hello"), &size));
+  EXPECT_EQ(cache.misses(), 1);
+
+  cache.insert(key("hello"), { 30.f, 13.f });
+  ASSERT_TRUE(cache.find(key("hello"), &size));
+  EXPECT_EQ(size.width, 30.f);
+  EXPECT_EQ(size.height, 13.f);
+  EXPECT_EQ(cache.hits(), 1);
+
+  EXPECT_FALSE(cache.find(key("hello", 20.f), &size));
+  EXPECT_FALSE(cache.find(key("world"), &size));
+}
+
+TEST(TextCacheTest, KeepsOwnCopyOfText) {
+  TextCache cache { 8 };
+  std::string text { "hello" };
+  cache.insert(key(text.c_str()), { 30.f, 13.f });
+  text = "world";
+
+  TextCache::Size size;
+  EXPECT_TRUE(cache.find(key("hello"), &size));
+  EXPECT_FALSE(cache.find(key(text.c_str()), &size));
+}
+
+TEST(TextCacheTest, EvictLeastRecentlyUsed) {
+  TextCache cache { 2 };
+  cache.insert(key("a"), { 1.f, 1.f });
+  cache.insert(key("b"), { 2.f, 1.f });
+
+  TextCache::Size size;
+  ASSERT_TRUE(cache.find(key("a"), &size));
+
+  cache.insert(key("c"), { 3.f, 1.f });
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_TRUE(cache.find(key("a"), &size));
+  EXPECT_FALSE(cache.find(key("b"), &size));
+  EXPECT_TRUE(cache.find(key("c"), &size));
+}
+
+TEST(TextCacheTest, ClearOnNewVersion) {
+  TextCache cache { 8 };
+  cache.setVersion(1);
+  cache.insert(key("a"), { 1.f, 1.f });
+  cache.setVersion(1);
+  EXPECT_EQ(cache.size(), 1);
+  cache.setVersion(2);
+  EXPECT_EQ(cache.size(), 0);
+}
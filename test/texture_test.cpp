@@ -122,3 +122,187 @@ TEST(TextureTest, UpdateCommands) {
     }));
   }
 }
+
+TEST(TextureTest, TouchNewGeneration) {
+  std::unique_ptr<ImGuiContext, decltype(&ImGui::DestroyContext)> ctx
+    { ImGui::CreateContext(), &ImGui::DestroyContext };
+
+  TextureManager manager;
+  TextureCookie  cookie;
+
+  Texture tex { (void *)0x10, 1.f, nullptr };
+  manager.touch(tex);
+
+  {
+    SCOPED_TRACE("insert");
+    CmdVector cmds;
+    manager.update(&cookie, LogCmds { cmds });
+    ASSERT_THAT(cmds, testing::ElementsAreArray(CmdVector {
+      { &manager, TextureCmd::Insert, 0, 1 }
+    }));
+  }
+
+  {
+    SCOPED_TRACE("same generation");
+    manager.touch(tex);
+
+    CmdVector cmds;
+    manager.update(&cookie, LogCmds { cmds });
+    ASSERT_THAT(cmds, testing::IsEmpty());
+  }
+
+  {
+    SCOPED_TRACE("new generation");
+    ++tex.generation;
+    manager.touch(tex);
+
+    CmdVector cmds;
+    manager.update(&cookie, LogCmds { cmds });
+    ASSERT_THAT(cmds, testing::ElementsAreArray(CmdVector {
+      { &manager, TextureCmd::Update, 0, 1 }
+    }));
+  }
+}
+
+TEST(TextureTest, UploadedByAllCookies) {
+  std::unique_ptr<ImGuiContext, decltype(&ImGui::DestroyContext)> ctx
+    { ImGui::CreateContext(), &ImGui::DestroyContext };
+
+  static std::vector<void *> uploads;
+  uploads.clear();
+
+  TextureManager manager;
+  TextureCookie  cookieA, cookieB;
+  const auto noop { [](const TextureCmd &) {} };
+
+  Texture tex { (void *)0x10, 1.f, nullptr };
+  tex.m_uploaded = [](void *user, float) { uploads.push_back(user); };
+  manager.touch(tex);
+
+  {
+    SCOPED_TRACE("insert");
+    manager.update(&cookieA, noop);
+    EXPECT_THAT(uploads, testing::ElementsAre((void *)0x10));
+    manager.update(&cookieB, noop); // new cookie, uploads again
+    EXPECT_THAT(uploads, testing::SizeIs(2));
+  }
+
+  {
+    SCOPED_TRACE("new generation");
+    ++tex.generation;
+    manager.touch(tex);
+
+    manager.update(&cookieA, noop);
+    EXPECT_THAT(uploads, testing::SizeIs(2)); // cookieB is not up to date
+    manager.update(&cookieB, noop);
+    EXPECT_THAT(uploads, testing::SizeIs(3));
+  }
+
+  {
+    SCOPED_TRACE("no changes");
+    manager.touch(tex);
+    manager.update(&cookieA, noop);
+    manager.update(&cookieB, noop);
+    EXPECT_THAT(uploads, testing::SizeIs(3));
+  }
+
+  {
+    SCOPED_TRACE("destroyed cookie");
+    auto cookieC { std::make_unique<TextureCookie>() };
+    manager.update(cookieC.get(), noop);
+    EXPECT_THAT(uploads, testing::SizeIs(4));
+
+    ++tex.generation;
+    manager.touch(tex);
+    manager.update(&cookieA, noop);
+    manager.update(&cookieB, noop);
+    EXPECT_THAT(uploads, testing::SizeIs(4)); // cookieC is not up to date
+    cookieC.reset();
+
+    ++tex.generation;
+    manager.touch(tex);
+    manager.update(&cookieA, noop);
+    manager.update(&cookieB, noop);
+    EXPECT_THAT(uploads, testing::SizeIs(5));
+  }
+}
+
+TEST(TextureTest, PartialUpdate) {
+  std::unique_ptr<ImGuiContext, decltype(&ImGui::DestroyContext)> ctx
+    { ImGui::CreateContext(), &ImGui::DestroyContext };
+
+  TextureManager manager;
+  TextureCookie  cookieA, cookieB;
+
+  Texture tex { (void *)0x10, 1.f, nullptr };
+  tex.m_changes = [](void *, float, const unsigned int since,
+      Texture::Region *region) {
+    *region = { static_cast<int>(since), 0, 10, 10 };
+    return true;
+  };
+  manager.touch(tex);
+
+  const auto noop { [](const TextureCmd &) {} };
+  manager.update(&cookieA, noop);
+  manager.update(&cookieB, noop);
+
+  auto getRegions { [&](TextureCookie *cookie) {
+    std::vector<std::pair<TextureCmd::Type, Texture::Region>> regions;
+    manager.update(cookie, [&](const TextureCmd &cmd) {
+      Texture::Region region {};
+      cmd.updateRegion(0, &region);
+      regions.emplace_back(cmd.type, region);
+    });
+    return regions;
+  } };
+
+  ++tex.generation;
+  manager.touch(tex);
+  {
+    SCOPED_TRACE("partial");
+    const auto regions { getRegions(&cookieA) };
+    ASSERT_EQ(regions.size(), 1);
+    EXPECT_EQ(regions[0].first, TextureCmd::Update);
+    EXPECT_EQ(regions[0].second.left,  0);
+    EXPECT_EQ(regions[0].second.right, 10);
+  }
+
+  ++tex.generation;
+  manager.touch(tex);
+  {
+    SCOPED_TRACE("union of the changes missed by cookieB");
+    const auto regions { getRegions(&cookieB) };
+    ASSERT_EQ(regions.size(), 1);
+    EXPECT_EQ(regions[0].second.left,  0);
+    EXPECT_EQ(regions[0].second.width(), 10);
+  }
+
+  manager.invalidate((void *)0x10);
+  {
+    SCOPED_TRACE("full invalidation");
+    const auto regions { getRegions(&cookieA) };
+    ASSERT_EQ(regions.size(), 1);
+    EXPECT_TRUE(regions[0].second.empty());
+  }
+
+  manager.invalidate((void *)0x10, 1.f, { 2, 3, 4, 5 });
+  {
+    SCOPED_TRACE("partial after full");
+    const auto regions { getRegions(&cookieA) };
+    ASSERT_EQ(regions.size(), 1);
+    EXPECT_EQ(regions[0].second.left,   2);
+    EXPECT_EQ(regions[0].second.bottom, 5);
+  }
+  {
+    SCOPED_TRACE("cookieB missed the full invalidation");
+    const auto regions { getRegions(&cookieB) };
+    ASSERT_EQ(regions.size(), 1);
+    EXPECT_TRUE(regions[0].second.empty());
+  }
+
+  manager.invalidate((void *)0x10, 2.f, { 0, 0, 1, 1 });
+  {
+    SCOPED_TRACE("partial for another scale");
+    EXPECT_THAT(getRegions(&cookieA), testing::IsEmpty());
+  }
+}
@@ -0,0 +1,86 @@
+#include "../src/tile_grid.hpp"
+
+#include <gtest/gtest.h>
+
+constexpr size_t TILE { TileGrid::TILE_SIZE };
+
+TEST(TileGridTest, Tiles) {
+  const TileGrid grid { (TILE * 2) + 10, TILE + 1, 4 };
+  EXPECT_EQ(grid.columns(), 3);
+  EXPECT_EQ(grid.rows(), 2);
+  EXPECT_EQ(grid.count(), 6);
+
+  const TileGrid::Tile first { grid.tile(0) };
+  EXPECT_EQ(first.x, 0);
+  EXPECT_EQ(first.y, 0);
+  EXPECT_EQ(first.width, TILE);
+  EXPECT_EQ(first.height, TILE);
+
+  // partial tiles at the right and bottom edges
+  const TileGrid::Tile last { grid.tile(5) };
+  EXPECT_EQ(last.x, TILE * 2);
+  EXPECT_EQ(last.y, TILE);
+  EXPECT_EQ(last.width, 10);
+  EXPECT_EQ(last.height, 1);
+  EXPECT_EQ(last.right(), (TILE * 2) + 10);
+  EXPECT_EQ(last.bottom(), TILE + 1);
+}
+
+TEST(TileGridTest, Border) {
+  const TileGrid grid { (TILE * 2) + 10, TILE + 1, 4 };
+
+  const TileGrid::Tile first { grid.withBorder(grid.tile(0)) };
+  EXPECT_EQ(first.x, 0);
+  EXPECT_EQ(first.y, 0);
+  EXPECT_EQ(first.width, TILE + 1);
+  EXPECT_EQ(first.height, TILE + 1);
+
+  const TileGrid::Tile middle { grid.withBorder(grid.tile(1)) };
+  EXPECT_EQ(middle.x, TILE - 1);
+  EXPECT_EQ(middle.width, TILE + 2);
+
+  // clamped to the image
+  const TileGrid::Tile last { grid.withBorder(grid.tile(5)) };
+  EXPECT_EQ(last.x, (TILE * 2) - 1);
+  EXPECT_EQ(last.y, TILE - 1);
+  EXPECT_EQ(last.width, 11);
+  EXPECT_EQ(last.height, 2);
+}
+
+TEST(TileGridTest, Key) {
+  for(const size_t index : { 0, 1, 42, 4095 }) {
+    const float key { TileGrid::key(index) };
+    EXPECT_LT(key, 0.f); // never mistaken for a scale
+    EXPECT_EQ(TileGrid::index(key), index);
+  }
+}
+
+TEST(TileGridTest, EvictLeastRecentlyUsed) {
+  TileGrid grid { TILE * 4, TILE, 2 };
+  EXPECT_FALSE(grid.isResident(0));
+
+  grid.use(0, grid.nextStamp());
+  grid.use(1, grid.nextStamp());
+  grid.use(2, grid.nextStamp());
+  const unsigned int stamp { grid.nextStamp() };
+  grid.use(3, stamp);
+
+  EXPECT_EQ(grid.evict(stamp), (std::vector<size_t> { 0, 1 }));
+  EXPECT_FALSE(grid.isResident(0));
+  EXPECT_FALSE(grid.isResident(1));
+  EXPECT_TRUE(grid.isResident(2));
+  EXPECT_TRUE(grid.isResident(3));
+  EXPECT_TRUE(grid.evict(stamp).empty());
+}
+
+TEST(TileGridTest, EvictKeepsCurrentDraw) {
+  TileGrid grid { TILE * 4, TILE, 2 };
+
+  // more tiles visible at once than the limit
+  const unsigned int stamp { grid.nextStamp() };
+  for(size_t i {}; i < 4; ++i)
+    grid.use(i, stamp);
+
+  EXPECT_TRUE(grid.evict(stamp).empty());
+  EXPECT_EQ(grid.evict(grid.nextStamp()).size(), 2);
+}
@@ -283,6 +283,7 @@ RESOURCES = {
   'ImGui_Image*'            => 'img',
   'ImGui_ImageSet*'         => 'set',
   'ImGui_ListClipper*'      => 'clipper',
+  'ImGui_PixelImage*'       => 'img',
   'ImGui_Resource*'         => 'obj',
   'ImGui_TextFilter*'       => 'filter',
   'ImGui_Viewport*'         => 'viewport',
@@ -0,0 +1,88 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../src/font.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+
+using Clock = std::chrono::steady_clock;
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+static Milliseconds resolve(const char *family, const int style,
+  Font::Source *source, bool *found = nullptr)
+{
+  const auto start { Clock::now() };
+  const bool ok { Font::resolve(family, style, source) };
+  const Milliseconds elapsed { Clock::now() - start };
+  if(found)
+    *found = ok;
+  return elapsed;
+}
+
+static int bench(const char *family, const int iterations)
+{
+  constexpr int STYLES[] {
+    ReaImGuiFontFlags_None, ReaImGuiFontFlags_Bold,
+    ReaImGuiFontFlags_Italic, ReaImGuiFontFlags_Bold | ReaImGuiFontFlags_Italic,
+  };
+
+  for(const int style : STYLES) {
+    Font::Source source;
+    bool found;
+    const Milliseconds first { resolve(family, style, &source, &found) };
+
+    Milliseconds repeated {};
+    for(int i {}; i < iterations; ++i)
+      repeated += resolve(family, style, &source);
+
+    const std::string *file { std::get_if<std::string>(&source.data) };
+    std::cout << std::left << std::setw(20) << family << std::right
+              << (style & ReaImGuiFontFlags_Bold   ? 'B' : '-')
+              << (style & ReaImGuiFontFlags_Italic ? 'I' : '-')
+              << std::fixed << std::setprecision(3)
+              << std::setw(10) << first.count() << " ms first"
+              << std::setw(10) << (repeated.count() / iterations) << " ms again"
+              << "  ";
+    if(!found)
+      std::cout << "(no match)";
+    else if(file)
+      std::cout << *file << ':' << source.index;
+    else
+      std::cout << "(in memory)";
+    std::cout << std::endl;
+  }
+
+  return 0;
+}
+
+int main(int argc, const char *argv[])
+{
+  const std::string_view command { argc > 1 ? argv[1] : "" };
+
+  if(command == "bench" && argc > 2) {
+    constexpr int ITERATIONS { 100 };
+    for(int i { 2 }; i < argc; ++i)
+      bench(argv[i], ITERATIONS);
+    return 0;
+  }
+
+  std::cerr << "Usage: " << argv[0] << " bench FAMILY..." << std::endl;
+  return 1;
+}
@@ -220,6 +220,7 @@ class ImGui_Font;
 class ImGui_Image;
 class ImGui_ImageSet;
 class ImGui_ListClipper;
+class ImGui_PixelImage;
 class ImGui_Resource;
 class ImGui_TextFilter;
 class ImGui_Viewport;
@@ -0,0 +1,213 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../src/error.hpp"
+#include "../src/file_buffer.hpp"
+#include "../src/image.hpp"
+#include "../src/image_formats.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+struct Pixels {
+  size_t width, height;
+  std::vector<unsigned char> data;
+};
+
+using Clock = std::chrono::steady_clock;
+
+static Pixels decode(const FileBuffer &file,
+  Clock::duration *timeToFirstRows = nullptr)
+{
+  const auto start { Clock::now() };
+
+  Pixels pixels;
+  auto decoder { Image::createDecoder(file.data(), file.size()) };
+  pixels.width  = decoder->width();
+  pixels.height = decoder->height();
+
+  // when the first rows could be shown to the user
+  Image::Decoder::ProgressFunc progress;
+  if(timeToFirstRows) {
+    *timeToFirstRows = {};
+    progress = [&](size_t) {
+      if(timeToFirstRows->count() == 0)
+        *timeToFirstRows = Clock::now() - start;
+    };
+  }
+
+  decoder->decode(pixels.data, progress);
+  return pixels;
+}
+
+static std::vector<unsigned char> encodeQOI(const Pixels &pixels)
+{
+  std::vector<unsigned char> out(QOI::HEADER_SIZE);
+  memcpy(out.data(), QOI::MAGIC, sizeof(QOI::MAGIC));
+  writeBigEndian32(&out[4], pixels.width);
+  writeBigEndian32(&out[8], pixels.height);
+  out[12] = 4; // channels
+  out[13] = 0; // sRGB with linear alpha
+
+  unsigned char index[64][4] {};
+  unsigned char prev[4] { 0, 0, 0, 255 };
+  unsigned int run {};
+
+  const unsigned char *px { pixels.data.data() },
+                      *end { px + pixels.data.size() };
+  for(; px < end; px += 4) {
+    if(!memcmp(px, prev, 4)) {
+      if(++run == 62 || px + 4 == end) {
+        out.push_back(QOI::OP_RUN | (run - 1));
+        run = 0;
+      }
+      continue;
+    }
+
+    if(run > 0) {
+      out.push_back(QOI::OP_RUN | (run - 1));
+      run = 0;
+    }
+
+    unsigned char *slot { index[QOI::hash(px)] };
+    if(!memcmp(slot, px, 4))
+      out.push_back(QOI::OP_INDEX | (slot - index[0]) / 4);
+    else {
+      memcpy(slot, px, 4);
+
+      if(px[3] != prev[3]) {
+        out.push_back(QOI::OP_RGBA);
+        out.insert(out.end(), px, px + 4);
+      }
+      else {
+        const signed char dr ( px[0] - prev[0] ), dg ( px[1] - prev[1] ),
+                          db ( px[2] - prev[2] );
+        const signed char dr_dg ( dr - dg ), db_dg ( db - dg );
+
+        if(dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2)
+          out.push_back(QOI::OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+        else if(dr_dg > -9 && dr_dg < 8 && dg > -33 && dg < 32 &&
+                db_dg > -9 && db_dg < 8) {
+          out.push_back(QOI::OP_LUMA | (dg + 32));
+          out.push_back((dr_dg + 8) << 4 | (db_dg + 8));
+        }
+        else {
+          out.push_back(QOI::OP_RGB);
+          out.insert(out.end(), px, px + 3);
+        }
+      }
+    }
+
+    memcpy(prev, px, 4);
+  }
+
+  out.insert(out.end(), std::begin(QOI::END_MARKER), std::end(QOI::END_MARKER));
+  return out;
+}
+
+static std::vector<unsigned char> encodeRaw(const Pixels &pixels)
+{
+  std::vector<unsigned char> out(RawRGBA::HEADER_SIZE);
+  memcpy(out.data(), RawRGBA::MAGIC, sizeof(RawRGBA::MAGIC));
+  writeBigEndian32(&out[sizeof(RawRGBA::MAGIC)],     pixels.width);
+  writeBigEndian32(&out[sizeof(RawRGBA::MAGIC) + 4], pixels.height);
+  out.insert(out.end(), pixels.data.begin(), pixels.data.end());
+  return out;
+}
+
+static int encode(const std::string_view format,
+  const char *input, const char *output)
+{
+  const Pixels pixels { decode(FileBuffer { input }) };
+
+  std::vector<unsigned char> encoded;
+  if(format == "qoi")
+    encoded = encodeQOI(pixels);
+  else if(format == "rgba")
+    encoded = encodeRaw(pixels);
+  else {
+    std::cerr << "unknown format '" << format << '\'' << std::endl;
+    return 1;
+  }
+
+  std::ofstream stream { output, std::ios::binary };
+  stream.write(reinterpret_cast<const char *>(encoded.data()), encoded.size());
+  if(!stream) {
+    std::cerr << output << ": write error" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+static int bench(const char *file, const int iterations)
+{
+  const FileBuffer input { file };
+  const Pixels pixels { decode(input) }; // warm up
+
+  Clock::duration firstRows, totalFirstRows {};
+  const auto start { Clock::now() };
+  for(int i {}; i < iterations; ++i) {
+    decode(input, &firstRows);
+    totalFirstRows += firstRows;
+  }
+  const std::chrono::duration<double> elapsed { Clock::now() - start };
+  const std::chrono::duration<double, std::milli> timeToFirstRows
+    { totalFirstRows / iterations };
+
+  const double decodedMB { pixels.data.size() * iterations / 1e6 };
+  std::cout << std::left << std::setw(40) << file << std::right
+            << std::setw(6)  << pixels.width << 'x'
+            << std::setw(6)  << std::left << pixels.height << std::right
+            << std::setw(10) << input.size() << " bytes"
+            << std::fixed << std::setprecision(3)
+            << std::setw(10) << (elapsed.count() * 1e3 / iterations) << " ms"
+            << std::setprecision(1)
+            << std::setw(10) << (decodedMB / elapsed.count()) << " MB/s"
+            << std::setprecision(3) << "  first rows after "
+            << timeToFirstRows.count() << " ms"
+            << std::endl;
+
+  return 0;
+}
+
+int main(int argc, const char *argv[])
+try {
+  const std::string_view command { argc > 1 ? argv[1] : "" };
+
+  if(command == "encode" && argc == 5)
+    return encode(argv[2], argv[3], argv[4]);
+  else if(command == "bench" && argc > 2) {
+    constexpr int ITERATIONS { 20 };
+    for(int i { 2 }; i < argc; ++i)
+      bench(argv[i], ITERATIONS);
+    return 0;
+  }
+
+  std::cerr << "Usage: " << argv[0] << " encode qoi|rgba INPUT OUTPUT\n"
+            << "       " << argv[0] << " bench FILE..." << std::endl;
+  return 1;
+}
+catch(const reascript_error &e) {
+  std::cerr << e.what() << std::endl;
+  return 1;
+}
@@ -0,0 +1,117 @@
+/* ReaImGui: ReaScript binding for Dear ImGui
+ * Copyright (C) 2021-2023  Christian Fillion
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../src/font.hpp"
+#include "../src/image.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <reaper_plugin_functions.h>
+#include <string_view>
+#include <typeinfo>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+using Nanoseconds = std::chrono::duration<double, std::nano>;
+
+// how resources were validated before having type tags
+template<typename T>
+static bool isValidRTTI(T *userData)
+{
+  Resource *resource { static_cast<Resource *>(userData) };
+  return Resource::isValid<Resource>(resource) &&
+    (typeid(*resource) == typeid(T) || dynamic_cast<T *>(resource));
+}
+
+template<typename T>
+static Nanoseconds measure(bool (*validate)(T *),
+  const std::vector<Resource *> &objects, const int iterations)
+{
+  size_t valid {};
+  const auto start { Clock::now() };
+  for(int i {}; i < iterations; ++i) {
+    // as given by scripts
+    for(Resource *object : objects)
+      valid += validate(reinterpret_cast<T *>(object));
+  }
+  const Nanoseconds elapsed { Clock::now() - start };
+
+  volatile size_t result { valid }; // don't optimize out the calls
+  static_cast<void>(result);
+
+  return elapsed / (static_cast<double>(iterations) * objects.size());
+}
+
+template<typename T>
+static void bench(const char *label, const std::vector<Resource *> &objects,
+  const int iterations)
+{
+  const Nanoseconds
+    before { measure(&isValidRTTI<T>,       objects, iterations) },
+    after  { measure(&Resource::isValid<T>, objects, iterations) };
+
+  std::cout << std::left << std::setw(16) << label << std::right
+            << std::fixed << std::setprecision(2)
+            << std::setw(8) << before.count() << " ns with RTTI"
+            << std::setw(8) << after.count()  << " ns with tags"
+            << std::endl;
+}
+
+static int bench(const int count, const int iterations)
+{
+  // resources register a timer in REAPER when the first one is created
+  GetMainHwnd     = []() -> HWND { return nullptr; };
+  plugin_register = [](const char *, void *) { return 0; };
+#ifndef _WIN32
+  GetWindowLong = [](HWND, int)           -> LONG_PTR { return 0; };
+  SetWindowLong = [](HWND, int, LONG_PTR) -> LONG_PTR { return 0; };
+#endif
+
+  // validated as various types, among other live resources
+  std::vector<Resource *> images;
+  for(int i {}; i < count; ++i) {
+    images.push_back(new PixelImage { 1, 1 });
+    new ImageSet;
+    new Font { "/dev/null", 13, ReaImGuiFontFlags_None };
+  }
+
+  std::cout << count * 3 << " live resources" << std::endl;
+  bench<PixelImage>("exact type",   images, iterations);
+  bench<Image>     ("parent type",  images, iterations);
+  bench<ImageSet>  ("sibling type", images, iterations);
+  bench<Font>      ("other type",   images, iterations);
+
+  Resource::destroyAll();
+  return 0;
+}
+
+int main(int argc, const char *argv[])
+{
+  const std::string_view command { argc > 1 ? argv[1] : "" };
+
+  if(command == "bench" && argc < 4) {
+    constexpr int ITERATIONS { 1000 };
+    const int count { argc > 2 ? atoi(argv[2]) : 1000 };
+    if(count > 0)
+      return bench(count, ITERATIONS);
+  }
+
+  std::cerr << "Usage: " << argv[0] << " bench [COUNT]" << std::endl;
+  return 1;
+}